@@ -0,0 +1,115 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+
+namespace chip8 {
+
+namespace audio {
+
+/// The CHIP-8 buzzer: a square wave that plays while the sound timer is
+/// nonzero. The whole tone is synthesized once at startup; the audio thread
+/// only walks a pointer over the cached buffer, and the sole state it shares
+/// with the emulation loop is one atomic on/off flag.
+class Beeper {
+
+    static constexpr int SAMPLE_RATE = 44100;
+    static constexpr int TONE_HZ = 440;
+    static constexpr int16_t AMPLITUDE = 3000;
+    /// Frames handed to the callback per pull; small enough that gating on
+    /// the flag reacts within ~12ms, comfortably inside one 60Hz tick.
+    static constexpr uint16_t DEVICE_BUFFER_FRAMES = 512;
+    /// A whole number of wave periods, so wrapping the read position never
+    /// produces a phase discontinuity (and its audible click).
+    static constexpr std::size_t WAVE_SAMPLES = (SAMPLE_RATE / TONE_HZ) * 16;
+
+    std::array<int16_t, WAVE_SAMPLES> wave{};
+    /// Read position into `wave`; touched only by the audio thread.
+    std::size_t position{0};
+    /// The only emulation-thread-to-audio-thread state: beep or stay silent.
+    std::atomic<bool> playing{false};
+    /// Stays 0 when no device could be opened: the beeper is then silent.
+    SDL_AudioDeviceID device{0};
+    bool subsystemUp{false};
+
+    static void Callback(void* userdata, Uint8* stream, int len) {
+        auto* self = static_cast<Beeper*>(userdata);
+        if (!self->playing.load(std::memory_order_relaxed)) {
+            std::memset(stream, 0, static_cast<std::size_t>(len));
+            self->position = 0;
+            return;
+        }
+        auto* out = reinterpret_cast<int16_t*>(stream);
+        const std::size_t samples = static_cast<std::size_t>(len) / sizeof(int16_t);
+        for (std::size_t i = 0; i < samples; i++) {
+            out[i] = self->wave[self->position];
+            self->position = (self->position + 1) % self->wave.size();
+        }
+    }
+
+   public:
+    /// A box with no working audio stack must not kill the emulator: on any
+    /// failure the beeper degrades to silence (device stays 0) instead of
+    /// throwing out of Run().
+    Beeper() {
+        // Audio is its own subsystem, brought up here on first use rather
+        // than with the video init.
+        if (SDL_InitSubSystem(SDL_INIT_AUDIO) != 0) {
+            std::fprintf(stderr, "[error] :: audio unavailable, running silent: %s\n", SDL_GetError());
+            return;
+        }
+        subsystemUp = true;
+
+        const std::size_t period = SAMPLE_RATE / TONE_HZ;
+        for (std::size_t i = 0; i < wave.size(); i++) {
+            wave[i] = (i % period) < (period / 2) ? AMPLITUDE : -AMPLITUDE;
+        }
+
+        SDL_AudioSpec desired{};
+        desired.freq = SAMPLE_RATE;
+        desired.format = AUDIO_S16SYS;
+        desired.channels = 1;
+        desired.samples = DEVICE_BUFFER_FRAMES;
+        desired.callback = &Beeper::Callback;
+        desired.userdata = this;
+        device = SDL_OpenAudioDevice(nullptr, 0, &desired, nullptr, 0);
+        if (device == 0) {
+            std::fprintf(stderr, "[error] :: no audio device, running silent: %s\n", SDL_GetError());
+            return;
+        }
+        // The device stays unpaused for its whole life: the callback writes
+        // silence while the flag is off, which keeps start/stop glitch-free.
+        SDL_PauseAudioDevice(device, 0);
+    }
+
+    Beeper(const Beeper&) = delete;
+    Beeper& operator=(const Beeper&) = delete;
+
+    ~Beeper() noexcept {
+        if (device != 0) {
+            SDL_CloseAudioDevice(device);
+        }
+        if (subsystemUp) {
+            SDL_QuitSubSystem(SDL_INIT_AUDIO);
+        }
+    }
+
+    /// Called from the emulation loop with `soundTimer > 0`. A no-op while
+    /// running silent.
+    void SetPlaying(const bool on) {
+        if (device == 0) {
+            return;
+        }
+        playing.store(on, std::memory_order_relaxed);
+    }
+};
+
+}  // namespace audio
+
+}  // namespace chip8
@@ -0,0 +1,134 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config.hpp"
+#include "emulator.hpp"
+
+namespace chip8 {
+
+namespace batch {
+
+/// Per-ROM budget when the caller does not pass --cycles: enough for the test
+/// ROMs in roms/ to settle while keeping a full manifest run in the seconds.
+constexpr uint64_t DEFAULT_INSTRUCTION_BUDGET = 1'000'000;
+
+struct RomResult {
+    std::string rom;
+    bool completed{false};
+    bool faulted{false};
+    uint64_t frameBufferHash{0};
+    chip8::system::CoreState cpu{};
+};
+
+/// Runs every ROM listed in the manifest (one path per line, '#' comments)
+/// on a pool of worker threads, each in its own headless Emulator, and prints
+/// a framebuffer hash plus the final register file per ROM in manifest order.
+inline int Run(const char* manifestPath, std::size_t jobs, Config config) {
+    std::vector<std::string> roms;
+    {
+        std::ifstream manifest{manifestPath};
+        if (!manifest) {
+            std::fprintf(stderr, "[error] :: could not open manifest '%s'\n", manifestPath);
+            return EXIT_FAILURE;
+        }
+        std::string line;
+        while (std::getline(manifest, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            roms.push_back(line);
+        }
+    }
+    if (roms.empty()) {
+        std::fprintf(stderr, "[error] :: manifest '%s' lists no ROMs\n", manifestPath);
+        return EXIT_FAILURE;
+    }
+
+    config.headless = true;
+    if (config.instructionBudget == 0) {
+        config.instructionBudget = DEFAULT_INSTRUCTION_BUDGET;
+    }
+    if (jobs == 0) {
+        const auto hardware = std::thread::hardware_concurrency();
+        jobs = (hardware > 0) ? hardware : 1;
+    }
+    if (jobs > roms.size()) {
+        jobs = roms.size();
+    }
+
+    std::vector<RomResult> results(roms.size());
+    std::atomic<std::size_t> nextRom{0};
+
+    // Every core (Memory + framebuffer + registers) is a few KiB, so workers
+    // mostly stay in cache and the run scales with the number of threads.
+    auto worker = [&]() {
+        while (true) {
+            const std::size_t index = nextRom.fetch_add(1);
+            if (index >= roms.size()) {
+                return;
+            }
+            RomResult& result = results[index];
+            result.rom = roms[index];
+            try {
+                chip8::Emulator emulator{config};
+                emulator.LoadFont(std::move(chip8::graphics::fonts::DEFAULT));
+                if (!emulator.LoadRomFromFile(roms[index].c_str())) {
+                    continue;
+                }
+                emulator.Run();
+                result.frameBufferHash = emulator.FrameBufferHash();
+                result.cpu = emulator.GetCpu();
+                result.faulted = emulator.Faulted();
+                result.completed = !result.faulted;
+            } catch (const std::exception& error) {
+                std::fprintf(stderr, "[error] :: %s: %s\n", roms[index].c_str(), error.what());
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(jobs);
+    for (std::size_t i = 0; i < jobs; i++) {
+        pool.emplace_back(worker);
+    }
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    bool allCompleted = true;
+    for (const auto& result : results) {
+        if (!result.completed) {
+            if (result.faulted) {
+                // An illegal opcode halted just that core and left a crash
+                // dump behind; the rest of the manifest already ran.
+                std::fprintf(stdout, "[batch] :: %s FAULTED at PC=0x%03x\n", result.rom.c_str(),
+                             result.cpu.PC);
+            } else {
+                std::fprintf(stdout, "[batch] :: %s FAILED\n", result.rom.c_str());
+            }
+            allCompleted = false;
+            continue;
+        }
+        std::fprintf(stdout, "[batch] :: %s hash=0x%016llx PC=0x%03x I=0x%03x SP=%u V=",
+                     result.rom.c_str(), static_cast<unsigned long long>(result.frameBufferHash),
+                     result.cpu.PC, result.cpu.I, static_cast<unsigned>(result.cpu.SP));
+        for (std::size_t i = 0; i < chip8::system::CoreState::NUMBER_OF_V_REGISTERS; i++) {
+            std::fprintf(stdout, "%02x", static_cast<unsigned>(result.cpu.V[i]));
+        }
+        std::fprintf(stdout, "\n");
+    }
+
+    return allCompleted ? EXIT_SUCCESS : EXIT_FAILURE;
+}
+
+}  // namespace batch
+
+}  // namespace chip8
@@ -0,0 +1,119 @@
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <vector>
+
+#include "config.hpp"
+#include "emulator.hpp"
+
+// Microbenchmark harness: drives the interpreter over synthetic instruction
+// streams, one per opcode category, and reports instructions per second.
+// Every perf-motivated change should come with before/after numbers from here.
+//
+// Usage: chip8-bench [repetitions] [instructions-per-run]
+
+namespace {
+
+struct BenchCase {
+    const char* name;
+    std::vector<uint8_t> rom;
+};
+
+/// Pure-ALU loop: immediate loads plus the whole 0x8 family, then jump back.
+std::vector<uint8_t> AluRom() {
+    return {
+        0x60, 0x0F,  // LD V0, 0x0F
+        0x61, 0x35,  // LD V1, 0x35
+        0x80, 0x14,  // ADD V0, V1
+        0x80, 0x15,  // SUB V0, V1
+        0x80, 0x11,  // OR V0, V1
+        0x80, 0x12,  // AND V0, V1
+        0x80, 0x13,  // XOR V0, V1
+        0x80, 0x16,  // SHR V0
+        0x80, 0x1E,  // SHL V0
+        0x12, 0x00,  // JP 0x200
+    };
+}
+
+/// Memory-heavy loop: Fx55/Fx65 bulk register stores and loads.
+std::vector<uint8_t> MemoryRom() {
+    return {
+        0xA3, 0x00,  // LD I, 0x300
+        0xF7, 0x55,  // LD [I], V7
+        0xF7, 0x65,  // LD V7, [I]
+        // Jump back to the LD I: the default core now uses COSMAC semantics
+        // where Fx55/Fx65 advance I, so it must be reloaded every iteration
+        // or the stores walk off the end of memory.
+        0x12, 0x00,  // JP 0x200
+    };
+}
+
+/// Draw-heavy loop: DXYN over the font sprite at a moving x position.
+std::vector<uint8_t> DrawRom() {
+    return {
+        0x60, 0x00,  // LD V0, 0
+        0x61, 0x00,  // LD V1, 0
+        0xA0, 0x50,  // LD I, font '0'
+        0xD0, 0x15,  // DRW V0, V1, 5
+        0x70, 0x07,  // ADD V0, 7
+        0x12, 0x06,  // JP 0x206
+    };
+}
+
+/// Runs one stream for `instructions` and returns instructions per second.
+double MeasureOnce(const std::vector<uint8_t>& rom, const uint64_t instructions) {
+    chip8::Config config{};
+    config.headless = true;
+    config.instructionBudget = instructions;
+
+    chip8::Emulator emulator{config};
+    emulator.LoadFont(std::move(chip8::graphics::fonts::DEFAULT));
+    emulator.LoadRom(std::vector<uint8_t>{rom});
+
+    const auto start = std::chrono::steady_clock::now();
+    emulator.Run();
+    const auto end = std::chrono::steady_clock::now();
+
+    const double seconds = std::chrono::duration<double>(end - start).count();
+    return static_cast<double>(instructions) / seconds;
+}
+
+}  // namespace
+
+int main(const int argc, const char** argv) {
+
+    uint64_t repetitions = 3;
+    uint64_t instructions = 5'000'000;
+    if (argc > 1) {
+        repetitions = std::strtoull(argv[1], nullptr, 10);
+    }
+    if (argc > 2) {
+        instructions = std::strtoull(argv[2], nullptr, 10);
+    }
+
+    const BenchCase cases[] = {
+        {"alu", AluRom()},
+        {"memory", MemoryRom()},
+        {"draw", DrawRom()},
+    };
+
+    std::fprintf(stdout, "[bench] :: %lu repetitions of %lu instructions (plus one warmup each)\n",
+                 static_cast<unsigned long>(repetitions), static_cast<unsigned long>(instructions));
+
+    for (const auto& benchCase : cases) {
+        // Warmup pass: fills caches and gets the CPU out of idle states.
+        MeasureOnce(benchCase.rom, instructions / 10);
+
+        double best = 0;
+        for (uint64_t i = 0; i < repetitions; i++) {
+            const double ips = MeasureOnce(benchCase.rom, instructions);
+            if (ips > best) {
+                best = ips;
+            }
+        }
+        std::fprintf(stdout, "[bench] :: %-8s %12.0f instr/s\n", benchCase.name, best);
+    }
+
+    return EXIT_SUCCESS;
+}
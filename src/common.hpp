@@ -0,0 +1,15 @@
+#pragma once
+
+#define CARRY_FLAG 0x0f
+
+#define PACK16(msb, lsb) (((uint16_t)(msb) << 0x08) | lsb)
+
+#define FIRST_NIBBLE(data) ((data >> 0x0c) & 0x0f)
+#define SECOND_NIBBLE(data) ((data >> 0x08) & 0x0f)
+#define THIRD_NIBBLE(data) ((data >> 0x04) & 0x0f)
+#define FOURTH_NIBBLE(data) ((data >> 0x00) & 0x0f)
+
+#define LSB(data) ((data & 0xff))
+#define MSB(data) ((data >> 0x08) & 0xff)
+
+#define TWELVE(data) (data & 0xfff)
@@ -0,0 +1,50 @@
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <optional>
+
+namespace chip8 {
+
+namespace concurrency {
+
+/// Lock-free single-producer/single-consumer ring buffer. Push drops the item
+/// when the queue is full rather than blocking, which is the right behaviour
+/// for input events: the producer is the render thread and must never stall.
+template <typename T, std::size_t Capacity>
+class SpscQueue {
+    static_assert((Capacity & (Capacity - 1)) == 0, "Capacity must be a power of two");
+
+    std::array<T, Capacity> items{};
+    std::atomic<std::size_t> head{0};
+    std::atomic<std::size_t> tail{0};
+
+   public:
+    bool Push(const T& item) {
+        const auto t = tail.load(std::memory_order_relaxed);
+        if (t - head.load(std::memory_order_acquire) == Capacity) {
+            return false;
+        }
+        items[t & (Capacity - 1)] = item;
+        tail.store(t + 1, std::memory_order_release);
+        return true;
+    }
+
+    /// Consumer-side peek, usable inside a wait predicate.
+    bool Empty() const { return head.load(std::memory_order_relaxed) == tail.load(std::memory_order_acquire); }
+
+    std::optional<T> Pop() {
+        const auto h = head.load(std::memory_order_relaxed);
+        if (h == tail.load(std::memory_order_acquire)) {
+            return std::nullopt;
+        }
+        T item = items[h & (Capacity - 1)];
+        head.store(h + 1, std::memory_order_release);
+        return item;
+    }
+};
+
+}  // namespace concurrency
+
+}  // namespace chip8
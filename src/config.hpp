@@ -0,0 +1,51 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+#include "graphics.hpp"
+
+namespace chip8 {
+
+struct Config {
+    static constexpr uint32_t DEFAULT_SCALE_FACTOR = 20;
+    static constexpr uint32_t DEFAULT_CPU_SPEED = 1000;
+
+    uint32_t scaleFactor{DEFAULT_SCALE_FACTOR};
+    /// How many machine cycles to emulate in 1 second. Most opcodes cost one
+    /// cycle; draws and register-file transfers are weighted heavier (see
+    /// EmulatorCore::CycleCost), so this only diverges from an instruction
+    /// rate on draw-heavy workloads.
+    uint32_t cpuSpeed{DEFAULT_CPU_SPEED};
+    /// Apply a scan line effect into emulator's screen.
+    bool useScanline{true};
+    /// Color of the scan line effect
+    chip8::graphics::colors::Color scanline{0x0f, 0x0f, 0x0f, 0xff};
+
+    chip8::graphics::colors::Color fgColor = chip8::graphics::colors::GREEN;
+    chip8::graphics::colors::Color bgColor = chip8::graphics::colors::BLACK;
+    /// XO-CHIP only: pixels lit on the second plane, and on both planes at once.
+    chip8::graphics::colors::Color plane2Color = chip8::graphics::colors::RED;
+    chip8::graphics::colors::Color planeBlendColor = chip8::graphics::colors::WHITE;
+
+    /// Instruction-rate multiplier applied while turbo is engaged (0 = uncapped).
+    uint32_t turboMultiplier{8};
+    /// Engage turbo from the start instead of only while Tab is held.
+    bool turboFromStart{false};
+
+    /// Run without a window: no SDL video init, no frame pacing. Meant for CI
+    /// boxes and batch testing where only the final CPU state matters.
+    bool headless{false};
+    /// Stop a headless run after this many instructions (0 = no limit).
+    uint64_t instructionBudget{0};
+    /// Seed for the CXNN generator. 0 seeds uniquely per instance; any other
+    /// value makes runs reproducible (for regression hash comparisons).
+    uint64_t randomSeed{0};
+
+    /// Keypad remapping: entry N is the SDL scancode bound to keypad key N,
+    /// added on top of the standard 1234/QWER/ASDF/ZXCV layout (0 = no extra
+    /// binding). Plain ints so the core config stays free of SDL headers.
+    std::array<int32_t, 16> keypadScancodes{};
+};
+
+}  // namespace chip8
@@ -0,0 +1,1947 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <cassert>
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <ctime>
+#include <iostream>
+#include <mutex>
+#include <optional>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "audio.hpp"
+#include "common.hpp"
+#include "concurrency.hpp"
+#include "config.hpp"
+#include "framebuffer.hpp"
+#include "graphics.hpp"
+#include "keymap.hpp"
+#include "random.hpp"
+#include "replay.hpp"
+#include "screen.hpp"
+#include "trace.hpp"
+#include "system.hpp"
+
+namespace chip8 {
+
+namespace debugger {};
+
+/// Dialect quirk profiles. Each one is a compile-time policy: the core is
+/// instantiated per profile and the handlers use `if constexpr`, so picking a
+/// dialect at ROM load costs nothing in the 0x8-family handlers that run
+/// millions of times per second in fast-forward.
+namespace quirks {
+
+/// Original COSMAC VIP semantics: 8XY6/8XYE shift Vy into Vx, Fx55/Fx65
+/// leave I pointing past the stored registers, BNNN adds V0.
+struct Chip8 {
+    static constexpr bool SHIFT_USES_VY = true;
+    static constexpr bool LOAD_STORE_ADVANCES_I = true;
+    static constexpr bool JUMP_OFFSET_USES_VX = false;
+    static constexpr std::size_t MEMORY_SIZE = 1 << 12;
+    static constexpr std::size_t DISPLAY_PLANES = 1;
+};
+
+/// SUPER-CHIP semantics: shifts operate on Vx in place, I is untouched by
+/// Fx55/Fx65, and BXNN reads the offset from Vx.
+struct Schip {
+    static constexpr bool SHIFT_USES_VY = false;
+    static constexpr bool LOAD_STORE_ADVANCES_I = false;
+    static constexpr bool JUMP_OFFSET_USES_VX = true;
+    static constexpr std::size_t MEMORY_SIZE = 1 << 12;
+    static constexpr std::size_t DISPLAY_PLANES = 1;
+};
+
+/// XO-CHIP keeps the original COSMAC semantics for the three flags; it earns
+/// its own profile because the dialect extends the machine itself: a 64KiB
+/// address space (reached through F000 NNNN long loads of I) and a second
+/// display plane selected with FN01.
+struct XoChip {
+    static constexpr bool SHIFT_USES_VY = true;
+    static constexpr bool LOAD_STORE_ADVANCES_I = true;
+    static constexpr bool JUMP_OFFSET_USES_VX = false;
+    static constexpr std::size_t MEMORY_SIZE = 1 << 16;
+    static constexpr std::size_t DISPLAY_PLANES = 2;
+};
+
+}  // namespace quirks
+
+/// A complete core snapshot: flat and trivially copyable, so saving is one
+/// memcpy and serializing to disk is a single fwrite of the struct. The
+/// whole register file (keypad and FX0A wait included) is the packed
+/// CoreState; only the memory image and display planes ride alongside.
+/// Sized by the display dimensions and the quirk profile (memory size,
+/// plane count) of the core it snapshots.
+template <uint32_t DisplayWidth, uint32_t DisplayHeight, typename Quirks = quirks::Chip8>
+struct SaveState {
+    chip8::system::CoreState core{};
+    std::array<uint8_t, Quirks::MEMORY_SIZE> memory{};
+    std::array<std::array<uint64_t, (DisplayWidth / 64) * DisplayHeight>, Quirks::DISPLAY_PLANES>
+        planes{};
+};
+
+static_assert(std::is_trivially_copyable_v<SaveState<chip8::display::DISPLAY_WIDTH, chip8::display::DISPLAY_HEIGHT>>,
+              "savestates must stay memcpy-able");
+
+/// The interpreter core, templated on the display size and the dialect quirk
+/// profile: the 64x32 CHIP-8 machine and the 128x64 SUPER-CHIP variant are
+/// separate full instantiations, so no core pays a runtime branch for another
+/// dialect's geometry or semantics.
+template <uint32_t DisplayWidth, uint32_t DisplayHeight, typename Quirks = quirks::Chip8>
+class EmulatorCore {
+    enum class Status { RUNNING, PAUSED, WAITING_FOR_KEY, STOPPED, FAULTED };
+
+    Config config{};
+
+    /// Display planes come from the quirk profile: 1 for CHIP-8/SUPER-CHIP,
+    /// 2 for XO-CHIP. Single-plane cores index `planes[0]` everywhere and
+    /// the loops collapse at compile time.
+    static constexpr std::size_t PLANES = Quirks::DISPLAY_PLANES;
+
+    using FrameBufferT = chip8::display::FrameBuffer<DisplayWidth, DisplayHeight>;
+    using ScreenT = chip8::display::Screen<DisplayWidth, DisplayHeight, PLANES>;
+    using SaveStateT = chip8::SaveState<DisplayWidth, DisplayHeight, Quirks>;
+    using MemoryT = chip8::system::MemorySized<Quirks::MEMORY_SIZE>;
+    /// One packed snapshot of every plane: what crosses to the render thread.
+    using Snapshot = std::array<typename FrameBufferT::WordArray, PLANES>;
+
+    // The packed register file sits directly in front of the memory image,
+    // so the interpreter's working set is one contiguous stretch.
+    chip8::system::CoreState cpu;
+    MemoryT memory;
+    std::array<FrameBufferT, PLANES> planes;
+    /// Only constructed for windowed runs: headless mode never initializes SDL video.
+    std::optional<ScreenT> screen;
+    /// Only constructed for windowed runs, alongside the screen.
+    std::optional<chip8::audio::Beeper> beeper;
+
+    Status currentStatuts{Status::RUNNING};
+
+    /// CXNN source. Per-instance, so batch workers never share generator state.
+    chip8::random::Xoshiro128 rng;
+
+    /// Instructions executed since power-on: the timestamp base for record-replay.
+    uint64_t instructionCount{0};
+
+    /// Cycles charged since power-on (see CycleCost): the virtual clock the
+    /// headless and hosted schedulers derive timer boundaries from.
+    uint64_t cycleCount{0};
+
+    /// Cycle at which the next timer decrement is due; the block executor
+    /// bails out here so the tick lands at the exact boundary, mid-block if
+    /// need be. The windowed scheduler drives timers off the wall clock
+    /// instead and leaves this parked at the maximum.
+    uint64_t nextTimerBoundary{UINT64_MAX};
+
+    /// Only engaged via --record / --replay (see StartRecording/StartReplay).
+    std::optional<chip8::replay::Recorder> recorder;
+    std::optional<chip8::replay::Replayer> replayer;
+
+    /// One frame-hash line per 60Hz tick when armed (see StartHashStream).
+    std::FILE* hashStream{nullptr};
+
+    /// Binary instruction tracing when armed (see StartTrace).
+    std::optional<chip8::trace::Tracer> tracer;
+
+    /// The last few executed instructions, kept unconditionally: one 8-byte
+    /// store into a cache-resident ring per instruction, so a crash dump can
+    /// always show how a core reached its fault (see WriteCrashDump).
+    static constexpr std::size_t HISTORY_SIZE = 32;
+    static_assert((HISTORY_SIZE & (HISTORY_SIZE - 1)) == 0, "history indices wrap with a mask");
+    std::array<chip8::trace::Record, HISTORY_SIZE> history{};
+
+    /// A key press/release crossing from the render thread to the emulation thread.
+    struct KeyEvent {
+        uint8_t key{0};
+        bool pressed{false};
+    };
+
+    /// Render thread produces, emulation thread consumes.
+    chip8::concurrency::SpscQueue<KeyEvent, 64> inputQueue;
+
+    /// Scancode-to-keypad translation, built once from the config.
+    chip8::input::ScancodeTable keymap = chip8::input::BuildDefaultTable();
+
+    /// Framebuffer snapshots double buffer. The emulation thread fills the
+    /// write-side buffer and flips `snapshotReady` to its index; the render
+    /// thread paints it and flips back to -1. The emulation thread never
+    /// touches a buffer while `snapshotReady` still points at it.
+    std::array<Snapshot, 2> snapshots{};
+    std::atomic<int> snapshotReady{-1};
+    int snapshotWriteIndex{0};
+
+    /// Cleared by either thread to shut the emulator down.
+    std::atomic<bool> running{false};
+
+    /// Set by the render thread while Tab is held; the emulation thread
+    /// multiplies (or uncaps) its instruction budget accordingly.
+    std::atomic<bool> turboHeld{false};
+
+    /// In turbo only every Kth published frame reaches the renderer.
+    static constexpr uint64_t TURBO_RENDER_INTERVAL = 8;
+    /// Burst size per scheduler iteration when turbo is uncapped.
+    static constexpr uint32_t UNCAPPED_BURST = 1 << 16;
+
+    /// Rewind keeps one snapshot per 60Hz tick: ~10 seconds of history.
+    static constexpr std::size_t REWIND_CAPACITY = 600;
+    /// Where F1/F2 save and load the on-disk state.
+    static constexpr const char* STATE_FILE = "chip8.state";
+
+    /// Ring buffer of per-frame snapshots, preallocated once for windowed runs
+    /// (about 2.7MB) so capturing is a single in-place memcpy, no allocation.
+    std::vector<SaveStateT> rewindBuffer{};
+    std::size_t rewindNext{0};
+    std::size_t rewindCount{0};
+
+    /// Hotkey requests crossing from the render thread to the emulation thread.
+    std::atomic<bool> rewindHeld{false};
+    std::atomic<bool> saveRequested{false};
+    std::atomic<bool> loadRequested{false};
+
+    /// Set while the emulation thread is parked in an FX0A wait, so the render
+    /// thread can stretch its own event timeout instead of waking at 60Hz.
+    std::atomic<bool> idleWaiting{false};
+    /// How long the render thread may block on the event queue while the core is idle.
+    static constexpr int IDLE_EVENT_TIMEOUT_MS = 500;
+
+    /// The render thread signals this after delivering events, so a parked
+    /// emulation thread wakes as soon as there is something to consume.
+    std::mutex wakeMutex;
+    std::condition_variable wakeCv;
+
+    /// Measured pacing over the last second, updated by the emulation thread
+    /// and read by whatever surfaces stats (shutdown log, overlays).
+    std::atomic<double> measuredHz{0};
+    std::atomic<double> measuredIps{0};
+
+    // HUD feed (see the F4 overlay): plain relaxed counters bumped on paths
+    // that already run, so a hidden HUD costs a handful of increments.
+
+    /// Per-frame milliseconds spent executing and pacing, averaged over the
+    /// same one-second stat window as measuredHz.
+    std::atomic<double> measuredEmulateMs{0};
+    std::atomic<double> measuredIdleMs{0};
+    /// Wall time the render thread spent inside the last Present.
+    std::atomic<double> measuredPresentMs{0};
+    /// Snapshots PublishFrame could not hand over because the renderer still
+    /// held the previous one.
+    std::atomic<uint64_t> droppedFrames{0};
+    /// DXYN count over the last completed 60Hz tick; the plain counter is
+    /// only touched by the emulation thread.
+    uint32_t drawsThisTick{0};
+    std::atomic<uint32_t> measuredDraws{0};
+    /// Toggled from the render thread with F4.
+    std::atomic<bool> hudEnabled{false};
+
+    using OpcodeHandler = void (EmulatorCore::*)(const uint16_t);
+
+    /// A predecoded instruction: the raw word plus its resolved handler, so the
+    /// hot path skips both the 16-bit fetch and the dispatch-table lookup.
+    struct DecodedInstruction {
+        OpcodeHandler handler{nullptr};
+        uint16_t instr{0};
+        /// Cycle charge (see CycleCost), filled in at decode time so the hot
+        /// path pays one add instead of re-deriving the weight per execution.
+        uint8_t cycles{1};
+    };
+
+    /// Relative cycle weight per opcode, inspired by the COSMAC VIP timing
+    /// tables: most opcodes take one machine cycle, draws pay per sprite row
+    /// and the register-file transfers pay per register moved. cpuSpeed counts
+    /// these cycles per second, so at a given speed a DXYN-heavy frame eats
+    /// more of the tick budget than a register-shuffling one — which is what
+    /// timer-polling and audio-sync-sensitive ROMs expect.
+    static constexpr uint8_t CycleCost(const uint16_t instr) {
+        switch (FIRST_NIBBLE(instr)) {
+            case 0xD: {
+                // DXY0 is the 16-row SCHIP sprite on the hi-res-capable core.
+                const uint8_t n = FOURTH_NIBBLE(instr);
+                if (DisplayWidth == 128 && n == 0) {
+                    return 6 + 16;
+                }
+                return static_cast<uint8_t>(6 + n);
+            }
+            case 0xF:
+                switch (instr & 0xff) {
+                    case 0x33: return 5;
+                    case 0x55:
+                    case 0x65: return static_cast<uint8_t>(2 + SECOND_NIBBLE(instr));
+                    default: return 1;
+                }
+            default:
+                return 1;
+        }
+    }
+
+    /// One entry per memory address, filled lazily the first time the PC lands there.
+    /// Memory clears the matching valid bits whenever it is written (see AttachDecodedCache).
+    std::array<DecodedInstruction, MemoryT::MEMORY_SIZE> decodedCache{};
+    std::array<bool, MemoryT::MEMORY_SIZE> decodedValid{};
+
+    /// Basic-block cache, layered over the predecode cache: for each address,
+    /// how many straight-line instructions run before the next control-flow
+    /// opcode. A block executes as a tight loop over the already-decoded
+    /// entries, with scheduler bookkeeping amortized over the whole run.
+    /// Memory clears the valid bits over a window on every write
+    /// (see AttachBlockCache), so self-modifying code falls back to a rebuild.
+    static constexpr std::size_t MAX_BLOCK_OPS = 32;
+    static_assert(2 * MAX_BLOCK_OPS <= MemoryT::BLOCK_INVALIDATION_WINDOW,
+                  "write invalidation must reach every block containing the written byte");
+    std::array<uint16_t, MemoryT::MEMORY_SIZE> blockLength{};
+    std::array<bool, MemoryT::MEMORY_SIZE> blockValid{};
+
+#ifdef CHIP8_PROFILE
+    /// One slot per leading nibble (opcode family): how many times it ran and
+    /// how many performance-counter ticks its handlers consumed. Only compiled
+    /// in with -DCHIP8_PROFILE (make profile) so the release hot path is untouched.
+    std::array<uint64_t, 16> profileCounts{};
+    std::array<uint64_t, 16> profileTicks{};
+#endif
+
+    void Jump(uint16_t instr, bool hasOffset = false) {
+        auto offset = (hasOffset) ? cpu.V[0] : 0;
+        cpu.PC = TWELVE(instr) + offset;
+    }
+
+    // Fixed-signature wrappers so every opcode fits the dispatch table below.
+
+    void JumpImmediate(const uint16_t instr) { Jump(instr, false); }
+
+    void JumpOffset(const uint16_t instr) {
+        // BNNN adds V0; the SUPER-CHIP dialect reads it as BXNN and adds Vx.
+        if constexpr (Quirks::JUMP_OFFSET_USES_VX) {
+            cpu.PC = TWELVE(instr) + cpu.V[SECOND_NIBBLE(instr)];
+        } else {
+            Jump(instr, true);
+        }
+    }
+
+    void SkipEqualImmediate(const uint16_t instr) { SkipEqual(instr, false); }
+
+    void SkipEqualRegister(const uint16_t instr) { SkipEqual(instr, true); }
+
+    void SkipNotEqualImmediate(const uint16_t instr) { SkipNotEqual(instr, false); }
+
+    void SkipNotEqualRegister(const uint16_t instr) { SkipNotEqual(instr, true); }
+
+    void LoadIntoV(uint16_t instr) {
+        // 6xkk - LD Vx, byte
+        auto x = SECOND_NIBBLE(instr);
+        assert(0 <= x && x < 0xf0);
+        cpu.V[x] = LSB(instr);
+    }
+
+    void SetIndexRegister(uint16_t instr) {
+        cpu.I = TWELVE(instr);  // SET Index Register I (0xANNN)
+    }
+
+    /// Applies `f` to every plane the FN01 mask selects. On single-plane
+    /// cores the mask is pinned to 1 and the compiler reduces this to a
+    /// direct call on `planes[0]`.
+    template <typename F>
+    void ForEachSelectedPlane(F f) {
+        for (std::size_t p = 0; p < PLANES; p++) {
+            if constexpr (PLANES > 1) {
+                if ((cpu.planeMask & (1u << p)) == 0) {
+                    continue;
+                }
+            }
+            f(planes[p]);
+        }
+    }
+
+    void ClearScreen(uint16_t) {
+        ForEachSelectedPlane([](FrameBufferT& plane) { plane.DrawAll(false); });
+        #ifdef DEBUG
+        std::fprintf(stdout, "[info] :: cleaning screen...\n");
+        #endif
+    }
+
+    void Call(const uint16_t instr) {
+        auto address = TWELVE(instr);
+        cpu.SP++;
+        cpu.stack[cpu.SP] = cpu.PC;
+        cpu.PC = address;
+    }
+
+    void ReturnFromRoutine(uint16_t) {
+        // Return from Subroutine
+        cpu.PC = cpu.stack[cpu.SP];
+        cpu.SP--;
+    }
+
+    // The 0x8 family lives in one small method per ALU operation so the
+    // dispatch table can jump straight to the right one without a second switch.
+
+    void MoveRegister(const uint16_t instr) {
+        // 8xy0 - LD Vx, Vy
+        cpu.V[SECOND_NIBBLE(instr)] = cpu.V[THIRD_NIBBLE(instr)];
+    }
+
+    void OrRegister(const uint16_t instr) {
+        // 8xy1 - OR Vx, Vy
+        cpu.V[SECOND_NIBBLE(instr)] |= cpu.V[THIRD_NIBBLE(instr)];
+    }
+
+    void AndRegister(const uint16_t instr) {
+        // 8xy2 - AND Vx, Vy
+        cpu.V[SECOND_NIBBLE(instr)] &= cpu.V[THIRD_NIBBLE(instr)];
+    }
+
+    void XorRegister(const uint16_t instr) {
+        // 8xy3 - XOR Vx, Vy
+        cpu.V[SECOND_NIBBLE(instr)] ^= cpu.V[THIRD_NIBBLE(instr)];
+    }
+
+    void AddRegisters(const uint16_t instr) {
+        // 8xy4 - ADD Vx, Vy
+        // Set Vx = Vx + Vy, set VF = carry.
+        auto x = SECOND_NIBBLE(instr);
+        uint8_t vx = cpu.V[x], vy = cpu.V[THIRD_NIBBLE(instr)];
+        if (static_cast<uint16_t>(vx) + static_cast<uint16_t>(vy) > 0xff) {
+            cpu.V[0xf] = 1;
+        } else {
+            cpu.V[0xf] = 0;
+        }
+        cpu.V[x] = vx + vy;
+    }
+
+    void SubRegisters(const uint16_t instr) {
+        // 8xy5 - SUB Vx, Vy
+        // Set Vx = Vx - Vy, set VF = NOT borrow.
+        auto x = SECOND_NIBBLE(instr);
+        uint8_t vx = cpu.V[x], vy = cpu.V[THIRD_NIBBLE(instr)];
+        if (vx > vy) {
+            cpu.V[0xf] = 1;
+        } else {
+            cpu.V[0xf] = 0;
+        }
+        cpu.V[x] = vx - vy;
+    }
+
+    void ShiftRight(const uint16_t instr) {
+        // 8xy6 - SHR Vx {, Vy}
+        // The original dialect shifts Vy into Vx; SUPER-CHIP shifts Vx in place.
+        auto x = SECOND_NIBBLE(instr);
+        uint8_t source;
+        if constexpr (Quirks::SHIFT_USES_VY) {
+            source = cpu.V[THIRD_NIBBLE(instr)];
+        } else {
+            source = cpu.V[x];
+        }
+        if (source & 1) {
+            cpu.V[0xf] = 1;
+        } else {
+            cpu.V[0xf] = 0;
+        }
+        cpu.V[x] = source >> 1;
+    }
+
+    void SubRegistersReversed(const uint16_t instr) {
+        // 8xy7 - SUBN Vx, Vy
+        // Set Vx = Vy - Vx, set VF = NOT borrow.
+        auto x = SECOND_NIBBLE(instr);
+        uint8_t vx = cpu.V[x], vy = cpu.V[THIRD_NIBBLE(instr)];
+        if (vy > vx) {
+            cpu.V[0xf] = 1;
+        } else {
+            cpu.V[0xf] = 0;
+        }
+        cpu.V[x] = vy - vx;
+    }
+
+    void ShiftLeft(const uint16_t instr) {
+        // 8xyE - SHL Vx {, Vy}
+        // The original dialect shifts Vy into Vx; SUPER-CHIP shifts Vx in place.
+        auto x = SECOND_NIBBLE(instr);
+        uint8_t source;
+        if constexpr (Quirks::SHIFT_USES_VY) {
+            source = cpu.V[THIRD_NIBBLE(instr)];
+        } else {
+            source = cpu.V[x];
+        }
+        if ((source >> 0x7) & 1) {
+            cpu.V[0xf] = 1;
+        } else {
+            cpu.V[0xf] = 0;
+        }
+        cpu.V[x] = source << 1;
+    }
+
+    /// An unknown opcode faults this core only: the host process (a 200-ROM
+    /// batch run, a grid wall) keeps going, and the full machine state plus
+    /// the recent-instruction ring land in a crash dump for the post-mortem.
+    void IllegalInstruction(const uint16_t instr) {
+        // The PC has already advanced past the fetch by the time we run.
+        const uint16_t faultPc = static_cast<uint16_t>(cpu.PC - 2);
+        currentStatuts = Status::FAULTED;
+        char dumpPath[64];
+        // The instance address keeps concurrent cores (batch/grid) from
+        // clobbering each other's dumps.
+        std::snprintf(dumpPath, sizeof(dumpPath), "chip8-crash-%03x-%p.dump", faultPc,
+                      static_cast<const void*>(this));
+        std::fprintf(stderr, "[error] :: illegal opcode 0x%04x at PC=0x%03x, core halted (dump: %s)\n",
+                     instr, faultPc, dumpPath);
+        WriteCrashDump(dumpPath);
+    }
+
+    /// Writes a 'C8CD' dump: the savestate struct followed by the history
+    /// ring, oldest instruction first.
+    void WriteCrashDump(const char* path) const {
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            std::fprintf(stderr, "[error] :: could not open crash dump '%s'\n", path);
+            return;
+        }
+        const uint8_t header[5] = {'C', '8', 'C', 'D', 1};
+        std::fwrite(header, 1, sizeof(header), file);
+        const SaveStateT state = CaptureState();
+        std::fwrite(&state, sizeof(state), 1, file);
+        // Slot n holds instruction n (mod ring size), so the oldest surviving
+        // record sits right after the latest one.
+        for (std::size_t i = 0; i < HISTORY_SIZE; i++) {
+            std::fwrite(&history[(instructionCount + 1 + i) & (HISTORY_SIZE - 1)],
+                        sizeof(chip8::trace::Record), 1, file);
+        }
+        std::fclose(file);
+    }
+
+#ifdef CHIP8_SWITCH_DISPATCH
+    void Assignment8(const uint16_t instr) {
+        switch (FOURTH_NIBBLE(instr)) {
+            case 0x0: MoveRegister(instr); break;
+            case 0x1: OrRegister(instr); break;
+            case 0x2: AndRegister(instr); break;
+            case 0x3: XorRegister(instr); break;
+            case 0x4: AddRegisters(instr); break;
+            case 0x5: SubRegisters(instr); break;
+            case 0x6: ShiftRight(instr); break;
+            case 0x7: SubRegistersReversed(instr); break;
+            case 0xE: ShiftLeft(instr); break;
+            default: IllegalInstruction(instr);
+        }
+    }
+#endif
+
+    void Add(const uint16_t instr) {
+        auto reg = SECOND_NIBBLE(instr);
+        assert(0x0 <= reg && reg <= 0xf);
+        cpu.V[reg] += LSB(instr);
+    }
+
+    void SkipEqual(const uint16_t instr, const bool compareRegister) {
+        // 4xkk/5xy0
+        auto reg = SECOND_NIBBLE(instr);
+        auto value = (compareRegister) ? (cpu.V[THIRD_NIBBLE(instr)]) : LSB(instr);
+        if (cpu.V[reg] == value) {
+            cpu.PC += 2;
+        }
+    }
+
+    void SkipNotEqual(const uint16_t instr, const bool compareRegister) {
+        // 4xkk - SNE Vx, byte  (compareRegister=false)
+        // 9xy0 - SNE Vx, Vy    (compareRegister=true)
+        auto x = SECOND_NIBBLE(instr);
+        auto value = (compareRegister) ? (cpu.V[THIRD_NIBBLE(instr)]) : LSB(instr);
+        if (cpu.V[x] != value) {
+            cpu.PC += 2;
+        }
+    }
+
+    /// Doubles every bit of a sprite byte: lo-res drawing on the hi-res core
+    /// stretches each 8-pixel row into a 16-pixel one.
+    static constexpr uint16_t StretchByte(const uint8_t bits) {
+        uint16_t v = bits;
+        v = (v | (v << 4)) & 0x0F0F;
+        v = (v | (v << 2)) & 0x3333;
+        v = (v | (v << 1)) & 0x5555;
+        return static_cast<uint16_t>(v | (v << 1));
+    }
+
+    /// Lo-res drawing on the hi-res core: the logical 64x32 grid maps onto
+    /// the 128x64 framebuffer with every pixel doubled, so each sprite row
+    /// stretches to 16 bits and lands on two adjacent framebuffer rows.
+    /// DXY0 is the SCHIP 1.x 8x16 sprite here, not the hi-res 16x16 one.
+    void DrawPixelsLoRes(const uint16_t instr, const uint8_t n) {
+        const std::size_t x = (cpu.V[SECOND_NIBBLE(instr)] % (DisplayWidth / 2)) * 2;
+        const std::size_t y = (cpu.V[THIRD_NIBBLE(instr)] % (DisplayHeight / 2)) * 2;
+        const std::size_t rows = (n == 0) ? 16 : n;
+        std::size_t offset = cpu.I;
+        ForEachSelectedPlane([&](FrameBufferT& plane) {
+            for (std::size_t i = 0; i < rows; i++) {
+                if (y + 2 * i >= DisplayHeight) break;
+                const uint16_t row = StretchByte(memory.Read8(WrapAddress(offset + i)));
+                bool erased = plane.XorSpriteRow16(y + 2 * i, x, row);
+                if (y + 2 * i + 1 < DisplayHeight) {
+                    erased |= plane.XorSpriteRow16(y + 2 * i + 1, x, row);
+                }
+                if (erased) {
+                    cpu.V[CARRY_FLAG] = 0x1;
+                }
+            }
+            offset += rows;
+        });
+    }
+
+    void DrawPixels(const uint16_t instr) {
+        const uint8_t n = FOURTH_NIBBLE(instr);
+        cpu.V[CARRY_FLAG] = 0;
+        drawsThisTick++;
+
+        if constexpr (DisplayWidth == 128) {
+            // The hi-res core boots in lo-res like the real machine: until
+            // 00FF flips the mode, draws go through the pixel-doubling path.
+            if (cpu.highRes == 0) {
+                DrawPixelsLoRes(instr, n);
+                return;
+            }
+        }
+
+        const uint8_t x = cpu.V[SECOND_NIBBLE(instr)] % DisplayWidth;
+        const uint8_t y = cpu.V[THIRD_NIBBLE(instr)] % DisplayHeight;
+
+        if constexpr (DisplayWidth == 128) {
+            // DXY0 - the SCHIP 16x16 sprite, two bytes per row. The base
+            // machine has no such opcode and draws nothing for N=0.
+            if (n == 0) {
+                std::size_t offset = cpu.I;
+                ForEachSelectedPlane([&](FrameBufferT& plane) {
+                    for (std::size_t i = 0; i < 16; i++) {
+                        if (y + i >= DisplayHeight) break;
+                        const uint16_t row = PACK16(memory.Read8(WrapAddress(offset + 2 * i)),
+                                                    memory.Read8(WrapAddress(offset + 2 * i + 1)));
+                        if (plane.XorSpriteRow16(y + i, x, row)) {
+                            cpu.V[CARRY_FLAG] = 0x1;
+                        }
+                    }
+                    offset += 32;
+                });
+                return;
+            }
+        }
+
+        // XO-CHIP feeds each selected plane its own n sprite rows, in plane
+        // order: with both planes selected the sprite is 2n bytes long. The
+        // word-wide XOR blit is the same on every plane.
+        std::size_t offset = cpu.I;
+        ForEachSelectedPlane([&](FrameBufferT& plane) {
+            for (std::size_t i = 0; i < n; i++) {
+                if (y + i >= DisplayHeight) break;
+
+                // The framebuffer aligns the 8-pixel row with column x and clips
+                // at the right edge; at most two word XORs per sprite row.
+                if (plane.XorSpriteRow(y + i, x, memory.Read8(WrapAddress(offset + i)))) {
+                    cpu.V[CARRY_FLAG] = 0x1;
+                }
+            }
+            offset += n;
+        });
+    }
+
+    // SUPER-CHIP scrolls, registered only for the 128x64 instantiation.
+    // All three are row-wise word shifts inside the packed framebuffer.
+
+    void ScrollDown(const uint16_t instr) {
+        // 00CN - scroll the display down by N lines.
+        ForEachSelectedPlane([&](FrameBufferT& plane) { plane.ScrollDown(FOURTH_NIBBLE(instr)); });
+    }
+
+    void ScrollRight(const uint16_t) {
+        // 00FB - scroll the display right by four pixels.
+        ForEachSelectedPlane([](FrameBufferT& plane) { plane.ScrollRight(); });
+    }
+
+    void ScrollLeft(const uint16_t) {
+        // 00FC - scroll the display left by four pixels.
+        ForEachSelectedPlane([](FrameBufferT& plane) { plane.ScrollLeft(); });
+    }
+
+    void EnterHighRes(const uint16_t) {
+        // 00FF - switch to the 128x64 mode. Mode switches blank every plane
+        // so the ROM starts drawing on a clean screen.
+        cpu.highRes = 1;
+        for (auto& plane : planes) {
+            plane.DrawAll(false);
+        }
+    }
+
+    void ExitHighRes(const uint16_t) {
+        // 00FE - back to the doubled 64x32 grid.
+        cpu.highRes = 0;
+        for (auto& plane : planes) {
+            plane.DrawAll(false);
+        }
+    }
+
+    // XO-CHIP extensions, registered only for multi-plane/64KiB profiles.
+
+    void SelectPlanes(const uint16_t instr) {
+        // FN01 - subsequent draws, clears and scrolls touch the planes in N.
+        cpu.planeMask = SECOND_NIBBLE(instr) & ((1u << PLANES) - 1);
+    }
+
+    void LoadLongIndex(const uint16_t instr) {
+        // F000 NNNN - I takes the full 16-bit word after the opcode, the only
+        // way to address past 0xFFF. Touches the PC, so it terminates blocks.
+        // The dispatch key only keeps the low byte, so every FX00 lands here:
+        // anything but F000 itself is an illegal opcode and must fault.
+        if (SECOND_NIBBLE(instr) != 0) {
+            IllegalInstruction(instr);
+            return;
+        }
+        cpu.I = memory.Read16(cpu.PC);
+        cpu.PC += 2;
+    }
+
+    void Random(const uint16_t instr) {
+        auto x = SECOND_NIBBLE(instr);
+        uint8_t draw = rng.NextByte();
+        if (replayer.has_value()) {
+            // Replays consume the recorded draw, so neither the seed nor the
+            // generator implementation can desync an old recording.
+            if (const auto* event = replayer->Peek();
+                event != nullptr && event->type == replay::EventType::RNG_DRAW) {
+                draw = event->value;
+                replayer->Advance();
+            }
+        } else if (recorder.has_value()) {
+            recorder->Append(instructionCount, replay::EventType::RNG_DRAW, draw);
+        }
+        cpu.V[x] = LSB(instr) & draw;
+    }
+
+    void LoadDelayTimer(const uint16_t instr) {
+        // Fx07 - Set Vx = delay timer value.
+        cpu.V[SECOND_NIBBLE(instr)] = cpu.delayTimer;
+    }
+
+    void WaitForKey(const uint16_t instr) {
+        // Fx0A
+        cpu.waitingKeyRegister = SECOND_NIBBLE(instr);
+        currentStatuts = Status::WAITING_FOR_KEY;
+    }
+
+    void SetDelayTimer(const uint16_t instr) {
+        // Fx15 - Set delay timer
+        cpu.delayTimer = cpu.V[SECOND_NIBBLE(instr)];
+    }
+
+    void SetSoundTimer(const uint16_t instr) {
+        // Fx18 - Set sound timer
+        cpu.soundTimer = cpu.V[SECOND_NIBBLE(instr)];
+    }
+
+    void AddToIndex(const uint16_t instr) {
+        // Fx1E - ADD I, Vx
+        cpu.I += cpu.V[SECOND_NIBBLE(instr)];
+    }
+
+    void LoadFontSprite(const uint16_t instr) {
+        // Fx29 - LD F, Vx
+        // Set I = location of sprite for digit Vx.
+        uint8_t vx = cpu.V[SECOND_NIBBLE(instr)];
+        cpu.I = static_cast<uint16_t>(vx) * 5 + graphics::fonts::FONT_ADDRESS_OFFSET;
+    }
+
+    /// Wraps an I-relative address into the address space. Dialects where
+    /// Fx55/Fx65 advance I can legitimately push it past MEMORY_SIZE, and
+    /// the release bus indexes raw, so every I-relative access must wrap
+    /// rather than run off the array. The size is a power of two: one AND.
+    static constexpr std::size_t WrapAddress(const std::size_t address) {
+        return address & (MemoryT::MEMORY_SIZE - 1);
+    }
+
+    void StoreBCD(const uint16_t instr) {
+        // Fx33 - LD B, Vx
+        // Store BCD representation of Vx in memory locations I, I+1, and I+2.
+        uint8_t vx = cpu.V[SECOND_NIBBLE(instr)];
+        memory.Write8(WrapAddress(cpu.I + 2), vx % 10);
+        vx /= 10;
+        memory.Write8(WrapAddress(cpu.I + 1), vx % 10);
+        vx /= 10;
+        memory.Write8(WrapAddress(cpu.I), vx);
+    }
+
+    void StoreRegisters(const uint16_t instr) {
+        // Fx55 - LD [I], Vx
+        for (std::size_t i = 0; i <= SECOND_NIBBLE(instr); i++) {
+            memory.Write8(WrapAddress(i + cpu.I), cpu.V[i]);
+        }
+        if constexpr (Quirks::LOAD_STORE_ADVANCES_I) {
+            // The original dialect leaves I pointing past the stored block.
+            cpu.I += SECOND_NIBBLE(instr) + 1;
+        }
+    }
+
+    void LoadRegisters(const uint16_t instr) {
+        // Fx65 - LD Vx, [I]
+        for (std::size_t i = 0; i <= SECOND_NIBBLE(instr); i++) {
+            cpu.V[i] = memory.Read8(WrapAddress(i + cpu.I));
+        }
+        if constexpr (Quirks::LOAD_STORE_ADVANCES_I) {
+            cpu.I += SECOND_NIBBLE(instr) + 1;
+        }
+    }
+
+#ifdef CHIP8_SWITCH_DISPATCH
+    void FDispatcher(const uint16_t instr) {
+        if constexpr (PLANES > 1) {
+            // XO-CHIP extensions, mirrored from the table-dispatch build.
+            switch (LSB(instr)) {
+                case 0x00: LoadLongIndex(instr); return;
+                case 0x01: SelectPlanes(instr); return;
+                default: break;
+            }
+        }
+        switch (LSB(instr)) {
+            case 0x07: LoadDelayTimer(instr); break;
+            case 0x0A: WaitForKey(instr); break;
+            case 0x15: SetDelayTimer(instr); break;
+            case 0x18: SetSoundTimer(instr); break;
+            case 0x1e: AddToIndex(instr); break;
+            case 0x29: LoadFontSprite(instr); break;
+            case 0x33: StoreBCD(instr); break;
+            case 0x55: StoreRegisters(instr); break;
+            case 0x65: LoadRegisters(instr); break;
+            default: IllegalInstruction(instr);
+        }
+    }
+#endif
+
+    void SkipIfKeyPressed(const uint16_t instr) {
+        // Ex9E - SKP Vx: Skip next instruction if key with the value of Vx is pressed.
+        if (cpu.keypad & (1u << (cpu.V[SECOND_NIBBLE(instr)] & 0xf))) {
+            cpu.PC += 2;
+        }
+    }
+
+    void SkipIfKeyNotPressed(const uint16_t instr) {
+        // ExA1 - SKNP Vx: Skip next instruction if key with the value of Vx is not pressed.
+        if (!(cpu.keypad & (1u << (cpu.V[SECOND_NIBBLE(instr)] & 0xf)))) {
+            cpu.PC += 2;
+        }
+    }
+
+#ifdef CHIP8_SWITCH_DISPATCH
+    void SkipIfKey(const uint16_t instr) {
+        uint8_t subop = LSB(instr);
+        if (subop == 0x9E) {
+            SkipIfKeyPressed(instr);
+        } else if (subop == 0xA1) {
+            SkipIfKeyNotPressed(instr);
+        }
+    }
+#endif
+
+    /// Runs on the render thread: translates SDL events into KeyEvents pushed
+    /// through the SPSC queue. The emulation thread owns the keypad bits and the
+    /// FX0A state, so nothing else is shared here.
+    /// Runs on the render thread, once per delivered SDL event.
+    void HandleEvent(const SDL_Event& event) {
+        if (event.type == SDL_QUIT) {
+            running.store(false, std::memory_order_relaxed);
+        }
+        if (event.type == SDL_WINDOWEVENT &&
+            event.window.event == SDL_WINDOWEVENT_SIZE_CHANGED) {
+            screen->HandleResize(event.window.data1, event.window.data2);
+        }
+        if (event.type == SDL_KEYUP) {
+            const auto key = event.key.keysym.sym;
+            if (key == SDLK_TAB) {
+                turboHeld.store(false, std::memory_order_relaxed);
+            }
+            if (key == SDLK_F3) {
+                rewindHeld.store(false, std::memory_order_relaxed);
+            }
+            PushKeypadEvent(event.key.keysym.scancode, false);
+        }
+        if (event.type == SDL_KEYDOWN) {
+            const auto key = event.key.keysym.sym;
+
+            // Escape quits the emulator. The hotkeys all live outside the 4x4
+            // keypad block so they never shadow a game key.
+            if (key == SDLK_ESCAPE) {
+                running.store(false, std::memory_order_relaxed);
+                return;
+            }
+
+            // Hold Tab for turbo (fast-forward).
+            if (key == SDLK_TAB) {
+                turboHeld.store(true, std::memory_order_relaxed);
+            }
+
+            // Hold F3 to rewind, F1/F2 to save/load the on-disk state.
+            if (key == SDLK_F3) {
+                rewindHeld.store(true, std::memory_order_relaxed);
+            }
+            if (key == SDLK_F1) {
+                saveRequested.store(true, std::memory_order_relaxed);
+            }
+            if (key == SDLK_F2) {
+                loadRequested.store(true, std::memory_order_relaxed);
+            }
+            // F4 toggles the performance HUD.
+            if (key == SDLK_F4) {
+                hudEnabled.store(!hudEnabled.load(std::memory_order_relaxed),
+                                 std::memory_order_relaxed);
+            }
+
+            PushKeypadEvent(event.key.keysym.scancode, true);
+        }
+    }
+
+    /// Translates a scancode through the lookup table: one array load per
+    /// event, no range chains, and the table already folds in any remapping.
+    void PushKeypadEvent(const SDL_Scancode scancode, const bool pressed) {
+        if (static_cast<std::size_t>(scancode) >= keymap.size()) {
+            return;
+        }
+        const uint8_t pad = keymap[scancode];
+        if (pad == input::NO_KEY) {
+            return;
+        }
+        inputQueue.Push({pad, pressed});
+        #ifdef DEBUG
+        std::fprintf(stdout, "[info] :: key %s index=%d\n", pressed ? "pressed" : "released", pad);
+        #endif
+    }
+
+    /// Applies one keypad transition and completes a pending FX0A wait.
+    /// Shared by the live input drain and the replay loop, so both resolve
+    /// waits through exactly the same logic.
+    void ApplyKey(const uint8_t key, const bool pressed) {
+        assert(key < 16);
+        if (pressed) {
+            cpu.keypad |= static_cast<uint16_t>(1u << key);
+            if (cpu.waitingKeyRegister != chip8::system::CoreState::NO_PENDING_KEY) {
+                cpu.V[cpu.waitingKeyRegister] = key;
+                cpu.waitingKeyRegister = chip8::system::CoreState::NO_PENDING_KEY;
+                currentStatuts = Status::RUNNING;
+            }
+        } else {
+            cpu.keypad &= static_cast<uint16_t>(~(1u << key));
+        }
+    }
+
+    /// Runs on the emulation thread: applies queued key events to the keypad
+    /// and completes a pending FX0A wait.
+    void DrainInputEvents() {
+        while (auto event = inputQueue.Pop()) {
+            if (recorder.has_value()) {
+                recorder->Append(instructionCount,
+                                 event->pressed ? replay::EventType::KEY_DOWN : replay::EventType::KEY_UP,
+                                 event->key);
+            }
+            ApplyKey(event->key, event->pressed);
+        }
+    }
+
+    /// Copies the framebuffer into the write-side snapshot buffer if anything
+    /// changed and the render thread has consumed the previous snapshot.
+    void PublishFrame() {
+        bool dirty = false;
+        for (const auto& plane : planes) {
+            dirty |= plane.IsDirty();
+        }
+        if (!dirty) {
+            return;
+        }
+        if (snapshotReady.load(std::memory_order_acquire) != -1) {
+            // Renderer still holds the last snapshot: keep the dirty bits and retry next tick.
+            droppedFrames.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        for (std::size_t p = 0; p < PLANES; p++) {
+            snapshots[snapshotWriteIndex][p] = planes[p].Words();
+            planes[p].ClearDirty();
+        }
+        snapshotReady.store(snapshotWriteIndex, std::memory_order_release);
+        snapshotWriteIndex ^= 1;
+    }
+
+    void CaptureStateInto(SaveStateT& state) const {
+        state.core = cpu;
+        state.memory = memory.Raw();
+        for (std::size_t p = 0; p < PLANES; p++) {
+            state.planes[p] = planes[p].Words();
+        }
+    }
+
+    void CaptureRewindState() {
+        if (rewindBuffer.empty()) {
+            return;
+        }
+        CaptureStateInto(rewindBuffer[rewindNext]);
+        rewindNext = (rewindNext + 1) % REWIND_CAPACITY;
+        if (rewindCount < REWIND_CAPACITY) {
+            rewindCount++;
+        }
+    }
+
+    void RewindOneFrame() {
+        if (rewindCount == 0) {
+            return;
+        }
+        rewindNext = (rewindNext + REWIND_CAPACITY - 1) % REWIND_CAPACITY;
+        rewindCount--;
+        RestoreState(rewindBuffer[rewindNext]);
+    }
+
+    /// The emulation thread body: an accumulator-based scheduler shared by
+    /// normal and turbo speed. Real elapsed time is converted into owed
+    /// cycles (see CycleCost) and timer ticks, so cpuSpeed no longer loses
+    /// its /60 remainder and the timers stay at exactly 60Hz whatever the
+    /// instruction rate is.
+    void EmulationLoop() {
+        const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+        uint64_t last = SDL_GetPerformanceCounter();
+        double cycleDebt = 0;
+        double timerDebt = 0;
+        uint64_t publishedFrames = 0;
+
+        // Measured-rate window: ticks, instructions and time split over the
+        // last ~second.
+        uint64_t statWindowStart = last;
+        uint64_t statTicks = 0;
+        uint64_t statInstructions = 0;
+        uint64_t statEmulateTicks = 0;
+        uint64_t statIdleTicks = 0;
+
+        while (running.load(std::memory_order_relaxed)) {
+            const uint64_t now = SDL_GetPerformanceCounter();
+            double dt = static_cast<double>(now - last) / frequency;
+            last = now;
+            // After a debugger stop or system stall, do not try to catch up for minutes.
+            if (dt > 0.25) {
+                dt = 0.25;
+            }
+
+            DrainInputEvents();
+
+            if (saveRequested.exchange(false, std::memory_order_relaxed)) {
+                SaveStateToFile(STATE_FILE);
+            }
+            if (loadRequested.exchange(false, std::memory_order_relaxed)) {
+                LoadStateFromFile(STATE_FILE);
+            }
+
+            const bool turbo = turboHeld.load(std::memory_order_relaxed) || config.turboFromStart;
+            const bool rewinding = rewindHeld.load(std::memory_order_relaxed);
+
+            timerDebt += dt * 60.0;
+            while (timerDebt >= 1.0) {
+                TickTimers();
+                timerDebt -= 1.0;
+                statTicks++;
+                // One snapshot (or one step back) per 60Hz tick.
+                if (rewinding) {
+                    RewindOneFrame();
+                } else {
+                    CaptureRewindState();
+                }
+            }
+
+            // One relaxed store gates the buzzer; the audio thread reads it
+            // and nothing else of ours.
+            if (beeper.has_value()) {
+                beeper->SetPlaying(cpu.soundTimer > 0);
+            }
+
+            const uint64_t emulateStart = SDL_GetPerformanceCounter();
+            if (rewinding || currentStatuts != Status::RUNNING) {
+                // Rewinding replaces execution, and a parked or faulted core
+                // executes nothing: either way do not bank time, or resuming
+                // (F2 state load after a fault) would pay the whole backlog
+                // off as one uncapped burst.
+                cycleDebt = 0;
+            } else {
+                if (turbo && config.turboMultiplier == 0) {
+                    // Uncapped: burn through a fixed burst per iteration, no
+                    // pacing. Whole blocks at a time, so the running/status
+                    // checks cost once per straight-line run, not per opcode.
+                    uint32_t burst = 0;
+                    while (burst < UNCAPPED_BURST && currentStatuts == Status::RUNNING &&
+                           running.load(std::memory_order_relaxed)) {
+                        burst += ExecuteBlock();
+                    }
+                    statInstructions += burst;
+                    cycleDebt = 0;
+                } else {
+                    cycleDebt += dt * config.cpuSpeed * (turbo ? config.turboMultiplier : 1);
+                    while (cycleDebt >= 1.0 && currentStatuts == Status::RUNNING) {
+                        // A block may overshoot the debt by a few cycles; the
+                        // accumulator goes negative and pays it back next tick.
+                        const uint64_t cyclesBefore = cycleCount;
+                        statInstructions += ExecuteBlock();
+                        cycleDebt -= static_cast<double>(cycleCount - cyclesBefore);
+                    }
+                }
+            }
+            statEmulateTicks += SDL_GetPerformanceCounter() - emulateStart;
+
+            if (!turbo || (++publishedFrames % TURBO_RENDER_INTERVAL) == 0) {
+                PublishFrame();
+            }
+
+            // Publish the measured rates about once a second.
+            const uint64_t statElapsed = SDL_GetPerformanceCounter() - statWindowStart;
+            if (static_cast<double>(statElapsed) >= frequency) {
+                const double seconds = static_cast<double>(statElapsed) / frequency;
+                measuredHz.store(static_cast<double>(statTicks) / seconds, std::memory_order_relaxed);
+                measuredIps.store(static_cast<double>(statInstructions) / seconds, std::memory_order_relaxed);
+                if (statTicks > 0) {
+                    // Per-frame milliseconds, so the HUD lines read against
+                    // the 16.7ms budget directly.
+                    const double toMsPerFrame = 1000.0 / (frequency * static_cast<double>(statTicks));
+                    measuredEmulateMs.store(static_cast<double>(statEmulateTicks) * toMsPerFrame,
+                                            std::memory_order_relaxed);
+                    measuredIdleMs.store(static_cast<double>(statIdleTicks) * toMsPerFrame,
+                                         std::memory_order_relaxed);
+                }
+                statWindowStart += statElapsed;
+                statTicks = 0;
+                statInstructions = 0;
+                statEmulateTicks = 0;
+                statIdleTicks = 0;
+            }
+
+            if (currentStatuts == Status::WAITING_FOR_KEY && !rewinding) {
+                // FX0A idle: park until input shows up or the next timer tick is
+                // due, instead of spinning at the scheduler rate. The timer debt
+                // keeps accumulating from real elapsed time, so delayTimer and
+                // soundTimer stay exact whatever the sleep granularity is.
+                const bool timersPending = cpu.delayTimer > 0 || cpu.soundTimer > 0;
+                const auto timeout = timersPending
+                                         ? std::chrono::duration<double>((1.0 - timerDebt) / 60.0)
+                                         : std::chrono::duration<double>(IDLE_EVENT_TIMEOUT_MS / 1000.0);
+                idleWaiting.store(true, std::memory_order_relaxed);
+                {
+                    std::unique_lock<std::mutex> lock{wakeMutex};
+                    wakeCv.wait_for(lock, timeout, [this]() {
+                        return !running.load(std::memory_order_relaxed) || !inputQueue.Empty() ||
+                               rewindHeld.load(std::memory_order_relaxed) ||
+                               saveRequested.load(std::memory_order_relaxed) ||
+                               loadRequested.load(std::memory_order_relaxed);
+                    });
+                }
+                idleWaiting.store(false, std::memory_order_relaxed);
+            } else if (!turbo) {
+                // Pace to the next exact 1/60s boundary instead of SDL_Delay(1):
+                // coarse sleep to within the OS scheduler quantum, then spin the
+                // final stretch so the timer rate does not drift with the kernel
+                // tick. The debt accumulators absorb whatever remains.
+                const uint64_t deadline =
+                    last + static_cast<uint64_t>(((1.0 - timerDebt) / 60.0) * frequency);
+                const uint64_t idleStart = SDL_GetPerformanceCounter();
+                SpinWaitUntil(deadline, frequency);
+                statIdleTicks += SDL_GetPerformanceCounter() - idleStart;
+            }
+        }
+    }
+
+    /// Sleeps in whole milliseconds while the deadline is comfortably far,
+    /// then busy-waits on the performance counter for the sub-millisecond
+    /// tail that SDL_Delay cannot hit.
+    static void SpinWaitUntil(const uint64_t deadline, const double frequency) {
+        while (true) {
+            const uint64_t now = SDL_GetPerformanceCounter();
+            if (now >= deadline) {
+                return;
+            }
+            const double remainingMs = static_cast<double>(deadline - now) / frequency * 1000.0;
+            if (remainingMs > 2.0) {
+                SDL_Delay(static_cast<uint32_t>(remainingMs - 2.0));
+            }
+        }
+    }
+
+    /// The table is indexed by (first nibble << 8) | low byte, so every opcode
+    /// family resolves in a single indirect jump: the low byte disambiguates
+    /// the 0x0/0x8/0xE/0xF sub-opcodes and is a don't-care for the others.
+    static constexpr std::size_t DISPATCH_TABLE_SIZE = 0x1000;
+
+    static constexpr std::size_t DispatchIndex(const uint16_t instr) {
+        return (static_cast<std::size_t>(FIRST_NIBBLE(instr)) << 8) | LSB(instr);
+    }
+
+    static std::array<OpcodeHandler, DISPATCH_TABLE_SIZE> BuildDispatchTable() {
+        std::array<OpcodeHandler, DISPATCH_TABLE_SIZE> table{};
+        table.fill(&EmulatorCore::IllegalInstruction);
+
+        auto fillFamily = [&table](const uint8_t opcode, const OpcodeHandler handler) {
+            for (std::size_t lsb = 0; lsb < 0x100; lsb++) {
+                table[(static_cast<std::size_t>(opcode) << 8) | lsb] = handler;
+            }
+        };
+
+        table[0x00E0] = &EmulatorCore::ClearScreen;
+        table[0x00EE] = &EmulatorCore::ReturnFromRoutine;
+        if constexpr (DisplayWidth == 128) {
+            // SCHIP scrolls only exist on the hi-res core.
+            for (std::size_t n = 0; n < 0x10; n++) {
+                table[0x00C0 | n] = &EmulatorCore::ScrollDown;
+            }
+            table[0x00FB] = &EmulatorCore::ScrollRight;
+            table[0x00FC] = &EmulatorCore::ScrollLeft;
+            table[0x00FE] = &EmulatorCore::ExitHighRes;
+            table[0x00FF] = &EmulatorCore::EnterHighRes;
+        }
+        fillFamily(0x1, &EmulatorCore::JumpImmediate);
+        fillFamily(0x2, &EmulatorCore::Call);
+        fillFamily(0x3, &EmulatorCore::SkipEqualImmediate);
+        fillFamily(0x4, &EmulatorCore::SkipNotEqualImmediate);
+        fillFamily(0x5, &EmulatorCore::SkipEqualRegister);
+        fillFamily(0x6, &EmulatorCore::LoadIntoV);
+        fillFamily(0x7, &EmulatorCore::Add);
+        // 0x8: only the fourth nibble selects the ALU operation, the third is the Y register.
+        for (std::size_t lsb = 0; lsb < 0x100; lsb++) {
+            OpcodeHandler handler = &EmulatorCore::IllegalInstruction;
+            switch (lsb & 0x0f) {
+                case 0x0: handler = &EmulatorCore::MoveRegister; break;
+                case 0x1: handler = &EmulatorCore::OrRegister; break;
+                case 0x2: handler = &EmulatorCore::AndRegister; break;
+                case 0x3: handler = &EmulatorCore::XorRegister; break;
+                case 0x4: handler = &EmulatorCore::AddRegisters; break;
+                case 0x5: handler = &EmulatorCore::SubRegisters; break;
+                case 0x6: handler = &EmulatorCore::ShiftRight; break;
+                case 0x7: handler = &EmulatorCore::SubRegistersReversed; break;
+                case 0xE: handler = &EmulatorCore::ShiftLeft; break;
+                default: break;
+            }
+            table[(static_cast<std::size_t>(0x8) << 8) | lsb] = handler;
+        }
+        fillFamily(0x9, &EmulatorCore::SkipNotEqualRegister);
+        fillFamily(0xA, &EmulatorCore::SetIndexRegister);
+        fillFamily(0xB, &EmulatorCore::JumpOffset);
+        fillFamily(0xC, &EmulatorCore::Random);
+        fillFamily(0xD, &EmulatorCore::DrawPixels);
+        table[(0xE << 8) | 0x9E] = &EmulatorCore::SkipIfKeyPressed;
+        table[(0xE << 8) | 0xA1] = &EmulatorCore::SkipIfKeyNotPressed;
+        table[(0xF << 8) | 0x07] = &EmulatorCore::LoadDelayTimer;
+        table[(0xF << 8) | 0x0A] = &EmulatorCore::WaitForKey;
+        table[(0xF << 8) | 0x15] = &EmulatorCore::SetDelayTimer;
+        table[(0xF << 8) | 0x18] = &EmulatorCore::SetSoundTimer;
+        table[(0xF << 8) | 0x1e] = &EmulatorCore::AddToIndex;
+        table[(0xF << 8) | 0x29] = &EmulatorCore::LoadFontSprite;
+        table[(0xF << 8) | 0x33] = &EmulatorCore::StoreBCD;
+        table[(0xF << 8) | 0x55] = &EmulatorCore::StoreRegisters;
+        table[(0xF << 8) | 0x65] = &EmulatorCore::LoadRegisters;
+        if constexpr (PLANES > 1) {
+            // XO-CHIP extensions only exist on the multi-plane core.
+            table[(0xF << 8) | 0x00] = &EmulatorCore::LoadLongIndex;
+            table[(0xF << 8) | 0x01] = &EmulatorCore::SelectPlanes;
+        }
+
+        return table;
+    }
+
+    /// Built once per instantiation, shared by the instruction and block paths.
+    static const std::array<OpcodeHandler, DISPATCH_TABLE_SIZE>& DispatchTable() {
+        static const std::array<OpcodeHandler, DISPATCH_TABLE_SIZE> table = BuildDispatchTable();
+        return table;
+    }
+
+    /// Control-flow opcodes end a basic block: anything that touches the PC,
+    /// plus FX0A (status change) and illegal opcodes (which abort).
+    static bool IsBlockTerminator(const OpcodeHandler handler) {
+        return handler == &EmulatorCore::JumpImmediate || handler == &EmulatorCore::JumpOffset ||
+               handler == &EmulatorCore::Call || handler == &EmulatorCore::ReturnFromRoutine ||
+               handler == &EmulatorCore::SkipEqualImmediate || handler == &EmulatorCore::SkipEqualRegister ||
+               handler == &EmulatorCore::SkipNotEqualImmediate ||
+               handler == &EmulatorCore::SkipNotEqualRegister || handler == &EmulatorCore::SkipIfKeyPressed ||
+               handler == &EmulatorCore::SkipIfKeyNotPressed || handler == &EmulatorCore::WaitForKey ||
+               handler == &EmulatorCore::LoadLongIndex || handler == &EmulatorCore::IllegalInstruction;
+    }
+
+#ifndef CHIP8_SWITCH_DISPATCH
+    /// Scans from `pc` to the next control-flow instruction, predecoding as it
+    /// goes, and records the straight-line run length. The terminator itself is
+    /// not part of the block: it runs through the per-instruction path.
+    void BuildBlock(const std::size_t rawPc) {
+        const std::size_t pc = WrapAddress(rawPc);
+        const auto& dispatchTable = DispatchTable();
+        uint16_t count = 0;
+        std::size_t p = pc;
+        while (count < MAX_BLOCK_OPS && p + 1 < MemoryT::MEMORY_SIZE) {
+            if (!decodedValid[p]) {
+                decodedCache[p].instr = memory.Read16(p);
+                decodedCache[p].handler = dispatchTable[DispatchIndex(decodedCache[p].instr)];
+                decodedCache[p].cycles = CycleCost(decodedCache[p].instr);
+                decodedValid[p] = true;
+            }
+            if (IsBlockTerminator(decodedCache[p].handler)) {
+                break;
+            }
+            count++;
+            p += 2;
+        }
+        blockLength[pc] = count;
+        blockValid[pc] = true;
+    }
+#endif
+
+    /// Executes one basic block plus its terminating control-flow instruction
+    /// and returns how many instructions ran, so callers can amortize their
+    /// budget bookkeeping over the whole run. Straight-line handlers never read
+    /// or write the PC, so the loop carries it in a local and stores it once.
+    uint32_t ExecuteBlock() {
+#if defined(CHIP8_SWITCH_DISPATCH) || defined(CHIP8_PROFILE)
+        // The legacy switch has no decode cache to build blocks from, and the
+        // profiler wants its timestamps around every single handler.
+        ExecuteNextInstruction();
+        return 1;
+#else
+        // Wrapped for the same reason the fetch path wraps: PC can sit one
+        // word past the last instruction of a full-sized ROM, and the cache
+        // arrays are exactly MEMORY_SIZE entries.
+        const std::size_t pc = WrapAddress(cpu.PC);
+        if (!blockValid[pc]) {
+            BuildBlock(pc);
+        }
+        const uint16_t n = blockLength[pc];
+        std::size_t p = pc;
+        for (uint16_t i = 0; i < n; i++) {
+            const DecodedInstruction decoded = decodedCache[p];
+            instructionCount++;
+            p += 2;
+            (this->*decoded.handler)(decoded.instr);
+            const chip8::trace::Record record{static_cast<uint16_t>(p - 2), decoded.instr,
+                                              cpu.V[SECOND_NIBBLE(decoded.instr)], cpu.V[0xf], cpu.I};
+            history[instructionCount & (HISTORY_SIZE - 1)] = record;
+            if (tracer.has_value()) {
+                tracer->Emit(record);
+            }
+            cycleCount += decoded.cycles;
+            if (!blockValid[pc] || cycleCount >= nextTimerBoundary) {
+                // Either a store (Fx55/Fx33) just landed inside this very block
+                // and the remaining decodes may be stale, or a timer decrement
+                // is due: bail out and let the scheduler sort it out.
+                cpu.PC = p;
+                return i + 1u;
+            }
+        }
+        cpu.PC = p;
+        ExecuteNextInstruction();
+        return n + 1u;
+#endif
+    }
+
+    void ExecuteNextInstruction() {
+        // Numbers the instruction being executed: record-replay timestamps
+        // taken inside a handler (CXNN) carry this count, ones taken between
+        // instructions carry the previous one, which keeps a single ordered
+        // event stream unambiguous.
+        instructionCount++;
+#ifndef CHIP8_SWITCH_DISPATCH
+        // Hot path: one array load per instruction. Fetch and decode only run
+        // when the cache entry was never filled or was invalidated by a write.
+        // The PC wraps like I does: a ROM ending flush against the top of the
+        // address space leaves PC == MEMORY_SIZE, and the caches index by it.
+        const auto& dispatchTable = DispatchTable();
+        const std::size_t pc = WrapAddress(cpu.PC);
+        DecodedInstruction& decoded = decodedCache[pc];
+        if (!decodedValid[pc]) {
+            decoded.instr = memory.Read16(pc);
+            decoded.handler = dispatchTable[DispatchIndex(decoded.instr)];
+            decoded.cycles = CycleCost(decoded.instr);
+            decodedValid[pc] = true;
+        }
+        cpu.PC = static_cast<uint16_t>(pc + 2);
+#ifdef CHIP8_PROFILE
+        const uint8_t profiledFamily = FIRST_NIBBLE(decoded.instr);
+        const uint64_t profileStart = SDL_GetPerformanceCounter();
+#endif
+        (this->*decoded.handler)(decoded.instr);
+#ifdef CHIP8_PROFILE
+        profileCounts[profiledFamily]++;
+        profileTicks[profiledFamily] += SDL_GetPerformanceCounter() - profileStart;
+#endif
+        const chip8::trace::Record record{static_cast<uint16_t>(pc), decoded.instr,
+                                          cpu.V[SECOND_NIBBLE(decoded.instr)], cpu.V[0xf], cpu.I};
+        history[instructionCount & (HISTORY_SIZE - 1)] = record;
+        if (tracer.has_value()) {
+            tracer->Emit(record);
+        }
+        cycleCount += decoded.cycles;
+#else
+        // Fecth the next instruction. The instruction has 4 nibbles.
+        // Wrapped like the cached path: PC may sit one word past the end.
+        const std::size_t fetchPc = WrapAddress(cpu.PC);
+        uint16_t instr = memory.Read16(fetchPc);
+        cpu.PC = static_cast<uint16_t>(fetchPc + 2);
+        // Legacy nested-switch interpreter, kept as a debugging fallback
+        // (build with -DCHIP8_SWITCH_DISPATCH to select it).
+        uint8_t opcode = FIRST_NIBBLE(instr);
+#ifdef CHIP8_PROFILE
+        const uint64_t profileStart = SDL_GetPerformanceCounter();
+#endif
+        switch (opcode) {
+            case 0x0: {
+                // Clear Screen
+                if (instr == 0x00E0) {
+                    ClearScreen(instr);
+                }
+                else if (instr == 0x00EE) {
+                    ReturnFromRoutine(instr);
+                }
+                else if (DisplayWidth == 128 && (instr & 0xFFF0) == 0x00C0) {
+                    ScrollDown(instr);
+                }
+                else if (DisplayWidth == 128 && instr == 0x00FB) {
+                    ScrollRight(instr);
+                }
+                else if (DisplayWidth == 128 && instr == 0x00FC) {
+                    ScrollLeft(instr);
+                }
+                else if (DisplayWidth == 128 && instr == 0x00FE) {
+                    ExitHighRes(instr);
+                }
+                else if (DisplayWidth == 128 && instr == 0x00FF) {
+                    EnterHighRes(instr);
+                }
+                else {
+                    IllegalInstruction(instr);
+                }
+                break;
+            }
+            case 0x1: {
+                Jump(instr);
+                break;
+            }
+            case 0x2: {
+                Call(instr);
+                break;
+            }
+            case 0x3: {
+                SkipEqual(instr, false);
+                break;
+            }
+            case 0x4: {
+                SkipNotEqual(instr, false);
+                break;
+            }
+            case 0x5: {
+                SkipEqual(instr, true);
+                break;
+            }
+            case 0x6: {
+                LoadIntoV(instr);
+                break;
+            }
+            case 0x7: {
+                Add(instr);
+                break;
+            }
+            case 0x8: {
+                Assignment8(instr);
+                break;
+            }
+            case 0x9: {
+                SkipNotEqual(instr, true);
+                break;
+            }
+            case 0xA: {
+                SetIndexRegister(instr);
+                break;
+            }
+            case 0xB: {
+                JumpOffset(instr);
+                break;
+            }
+            case 0xC: {
+                Random(instr);
+                break;
+            }
+            case 0xD: {
+                DrawPixels(instr);
+                break;
+            }
+            case 0xE: {
+                SkipIfKey(instr);
+                break;
+            }
+            case 0xF: {
+                FDispatcher(instr);
+                break;
+            }
+            default: {
+                IllegalInstruction(instr);
+            }
+        }
+#ifdef CHIP8_PROFILE
+        profileCounts[opcode]++;
+        profileTicks[opcode] += SDL_GetPerformanceCounter() - profileStart;
+#endif
+        const chip8::trace::Record record{static_cast<uint16_t>(fetchPc), instr,
+                                          cpu.V[SECOND_NIBBLE(instr)], cpu.V[0xf], cpu.I};
+        history[instructionCount & (HISTORY_SIZE - 1)] = record;
+        if (tracer.has_value()) {
+            tracer->Emit(record);
+        }
+        cycleCount += CycleCost(instr);
+#endif
+    }
+
+    void TickTimers() {
+        if (hashStream != nullptr) {
+            std::fprintf(hashStream, "%016llx\n", static_cast<unsigned long long>(FrameBufferHash()));
+        }
+        if (recorder.has_value()) {
+            // Live timer ticks land at wall-clock-dependent instruction counts,
+            // so they are part of the recording too.
+            recorder->Append(instructionCount, replay::EventType::TIMER_TICK, 0);
+        }
+        if (cpu.delayTimer > 0) { cpu.delayTimer--; }
+        if (cpu.soundTimer > 0) { cpu.soundTimer--; }
+        // Publish the tick's draw count for the HUD and start the next one.
+        measuredDraws.store(drawsThisTick, std::memory_order_relaxed);
+        drawsThisTick = 0;
+    }
+
+#ifdef CHIP8_PROFILE
+    /// Prints the per-family profile sorted by total time, most expensive first.
+    /// Called once on exit, after the emulation thread has stopped.
+    void DumpProfile() const {
+        uint64_t totalTicks = 0;
+        for (const auto ticks : profileTicks) {
+            totalTicks += ticks;
+        }
+        if (totalTicks == 0) {
+            return;
+        }
+
+        std::array<std::size_t, 16> order{};
+        for (std::size_t i = 0; i < order.size(); i++) {
+            order[i] = i;
+        }
+        std::sort(order.begin(), order.end(),
+                  [this](const std::size_t a, const std::size_t b) { return profileTicks[a] > profileTicks[b]; });
+
+        const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+        std::fprintf(stdout, "[profile] :: family      count     total ms   share\n");
+        for (const auto family : order) {
+            if (profileCounts[family] == 0) {
+                continue;
+            }
+            const double ms = static_cast<double>(profileTicks[family]) / frequency * 1000.0;
+            const double share = 100.0 * static_cast<double>(profileTicks[family]) / static_cast<double>(totalTicks);
+            std::fprintf(stdout, "[profile] :: 0x%zXnnn %10lu %12.3f %6.2f%%\n", family,
+                         static_cast<unsigned long>(profileCounts[family]), ms, share);
+        }
+    }
+#endif
+
+    /// Replays a recorded session flat out: no window, no pacing, timers and
+    /// input re-applied at their recorded instruction counts. Heisenbugs that
+    /// took minutes of play reproduce in well under a second, and bisecting is
+    /// rerunning the replay with a different build.
+    void RunReplay() {
+        while (currentStatuts == Status::RUNNING || currentStatuts == Status::WAITING_FOR_KEY) {
+            // Apply everything recorded at or before this point. RNG draws are
+            // left in place: the CXNN handler consumes those itself.
+            while (const auto* event = replayer->Peek()) {
+                if (event->instruction > instructionCount ||
+                    event->type == replay::EventType::RNG_DRAW) {
+                    break;
+                }
+                switch (event->type) {
+                    case replay::EventType::KEY_DOWN: ApplyKey(event->value, true); break;
+                    case replay::EventType::KEY_UP: ApplyKey(event->value, false); break;
+                    case replay::EventType::TIMER_TICK: TickTimers(); break;
+                    default: break;
+                }
+                replayer->Advance();
+            }
+
+            if (currentStatuts == Status::WAITING_FOR_KEY) {
+                // Whatever resolved this FX0A wait in the recording has been
+                // applied above; still being parked means the stream ran out.
+                std::fprintf(stdout, "[info] :: replay halted on FX0A after %lu instructions\n",
+                             static_cast<unsigned long>(instructionCount));
+                break;
+            }
+            if (replayer->Done()) {
+                // The recorded horizon: past it the run would just diverge.
+                break;
+            }
+
+            // Stays on the per-instruction path: recorded events must land at
+            // exact instruction counts, which block execution would overshoot.
+            ExecuteNextInstruction();
+            if (config.instructionBudget != 0 && instructionCount >= config.instructionBudget) {
+                break;
+            }
+        }
+
+        std::fprintf(stdout, "[info] :: replay finished: %lu instructions, frame hash 0x%016lx\n",
+                     static_cast<unsigned long>(instructionCount),
+                     static_cast<unsigned long>(FrameBufferHash()));
+    }
+
+    /// Runs the interpreter flat out, with no event polling and no frame pacing.
+    /// Timers still tick once every cpuSpeed/60 cycles, and the block executor
+    /// bails at that boundary (one counter compare per instruction), so a ROM
+    /// polling FX07 mid-burst sees the decrement at the exact cycle it is due
+    /// instead of after the whole tick's burst.
+    void RunHeadless() {
+        const uint32_t cyclesPerTick = config.cpuSpeed / 60;
+        uint64_t executed = 0;
+        nextTimerBoundary = cycleCount + cyclesPerTick;
+
+        while (currentStatuts == Status::RUNNING) {
+            executed += ExecuteBlock();
+            if (cycleCount >= nextTimerBoundary) {
+                TickTimers();
+                nextTimerBoundary += cyclesPerTick;
+            }
+            if (config.instructionBudget != 0 && executed >= config.instructionBudget) {
+                break;
+            }
+        }
+
+        if (currentStatuts == Status::WAITING_FOR_KEY) {
+            // FX0A can never complete without an input source: stop here instead of spinning.
+            std::fprintf(stdout, "[info] :: headless run halted on FX0A after %lu instructions\n",
+                         static_cast<unsigned long>(executed));
+        }
+    }
+
+   public:
+    explicit EmulatorCore(const Config& c = Config{}) : config{c} {
+        if (config.randomSeed != 0) {
+            // Fixed seed: CXNN draws (and so framebuffer hashes) are reproducible.
+            rng.Reseed(config.randomSeed);
+        } else {
+            // Mix the instance address in so emulators created in the same
+            // second (the batch runner) still diverge.
+            rng.Reseed(static_cast<uint64_t>(std::time(nullptr)) ^
+                       static_cast<uint64_t>(reinterpret_cast<std::uintptr_t>(this)));
+        }
+        memory.AttachDecodedCache(&decodedValid);
+        memory.AttachBlockCache(&blockValid);
+        keymap = chip8::input::BuildTable(config);
+    }
+
+    EmulatorCore(const chip8::graphics::fonts::Font&& font) : EmulatorCore{} {
+        LoadFont(std::move(font));
+    }
+
+    ~EmulatorCore() {
+        if (hashStream != nullptr) {
+            std::fclose(hashStream);
+        }
+    }
+
+    void LoadFont(const chip8::graphics::fonts::Font&& font) { memory.WriteBytes(std::move(font), graphics::fonts::FONT_ADDRESS_OFFSET); }
+
+    void LoadRom(const std::vector<uint8_t>&& rom) {
+        memory.WriteBytes(std::move(rom), chip8::system::CoreState::STARTING_PC);
+    }
+
+    /// Reads a ROM off disk straight into memory at STARTING_PC: one fread
+    /// into the memory array, no intermediate vector and no copy.
+    bool LoadRomFromFile(const char* path) {
+        std::FILE* file = std::fopen(path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+        if (size <= 0 ||
+            static_cast<std::size_t>(size) >= MemoryT::MEMORY_SIZE - chip8::system::CoreState::STARTING_PC) {
+            std::fclose(file);
+            return false;
+        }
+        uint8_t* destination = memory.WritableWindow(chip8::system::CoreState::STARTING_PC, static_cast<std::size_t>(size));
+        const std::size_t read = std::fread(destination, 1, static_cast<std::size_t>(size), file);
+        std::fclose(file);
+        return read == static_cast<std::size_t>(size);
+    }
+
+    SaveStateT CaptureState() const {
+        SaveStateT state{};
+        CaptureStateInto(state);
+        return state;
+    }
+
+    void RestoreState(const SaveStateT& state) {
+        cpu = state.core;
+        memory.Restore(state.memory);
+        for (std::size_t p = 0; p < PLANES; p++) {
+            planes[p].Restore(state.planes[p]);
+        }
+        // The FX0A wait travels inside the packed register file.
+        currentStatuts = (cpu.waitingKeyRegister != chip8::system::CoreState::NO_PENDING_KEY)
+                             ? Status::WAITING_FOR_KEY
+                             : Status::RUNNING;
+    }
+
+    bool SaveStateToFile(const char* path) const {
+        const SaveStateT state = CaptureState();
+        std::FILE* file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            std::fprintf(stderr, "[error] :: could not open '%s' for writing\n", path);
+            return false;
+        }
+        const bool ok = std::fwrite(&state, sizeof(state), 1, file) == 1;
+        std::fclose(file);
+        return ok;
+    }
+
+    bool LoadStateFromFile(const char* path) {
+        SaveStateT state{};
+        std::FILE* file = std::fopen(path, "rb");
+        if (file == nullptr) {
+            std::fprintf(stderr, "[error] :: could not open '%s' for reading\n", path);
+            return false;
+        }
+        const bool ok = std::fread(&state, sizeof(state), 1, file) == 1;
+        std::fclose(file);
+        if (ok) {
+            RestoreState(state);
+        }
+        return ok;
+    }
+
+    /// Read-only view of the register file, used by the batch runner's reports.
+    const chip8::system::CoreState& GetCpu() const { return cpu; }
+
+    /// Whether this core halted on an illegal opcode (see IllegalInstruction);
+    /// batch and grid hosts report it and carry on with the other cores.
+    bool Faulted() const { return currentStatuts == Status::FAULTED; }
+
+    /// Starts logging keypad transitions, CXNN draws and timer ticks to `path`
+    /// (see --record). Recording assumes a plain run: savestate loads and
+    /// rewinds are not part of the stream and would desync a replay.
+    bool StartRecording(const char* path) {
+        recorder.emplace();
+        if (!recorder->Open(path)) {
+            recorder.reset();
+            return false;
+        }
+        return true;
+    }
+
+    /// Loads a recorded session (see --replay); Run() then replays it
+    /// deterministically, headless and uncapped.
+    bool StartReplay(const char* path) {
+        replayer.emplace();
+        if (!replayer->Load(path)) {
+            replayer.reset();
+            return false;
+        }
+        return true;
+    }
+
+    /// Streams one binary trace record per executed instruction to `path`
+    /// (see --trace); pretty-print the result with --trace-dump.
+    bool StartTrace(const char* path) {
+        tracer.emplace();
+        if (!tracer->Open(path)) {
+            tracer.reset();
+            return false;
+        }
+        return true;
+    }
+
+    /// Arms a memory watchpoint; only effective on debug builds, where the
+    /// checked bus is selected (see system::Memory).
+    void AddWatchpoint(const uint16_t address, const bool onRead, const bool onWrite) {
+        memory.AddWatchpoint(address, onRead, onWrite);
+    }
+
+    /// Advances one 60Hz tick for an external host (grid mode): a tick's
+    /// worth of instructions followed by one timer decrement. An FX0A wait
+    /// simply idles, since hosted cores have no input source of their own.
+    void StepTick() {
+        if (currentStatuts == Status::FAULTED) {
+            // The fault froze this core; the rest of the wall keeps running.
+            return;
+        }
+        nextTimerBoundary = cycleCount + config.cpuSpeed / 60;
+        while (cycleCount < nextTimerBoundary && currentStatuts == Status::RUNNING) {
+            ExecuteBlock();
+        }
+        TickTimers();
+    }
+
+    // Packed framebuffer rows plus dirty tracking, for external presenters
+    // that composite many cores into one window (grid mode).
+
+    const auto& FrameWords() const { return planes[0].Words(); }
+    bool FrameDirty() const {
+        bool dirty = false;
+        for (const auto& plane : planes) {
+            dirty |= plane.IsDirty();
+        }
+        return dirty;
+    }
+    void ClearFrameDirty() {
+        for (auto& plane : planes) {
+            plane.ClearDirty();
+        }
+    }
+
+    /// Measured 60Hz-tick and instruction rates over the last second of the
+    /// windowed scheduler; zero until the first window completes.
+    double MeasuredHz() const { return measuredHz.load(std::memory_order_relaxed); }
+    double MeasuredIps() const { return measuredIps.load(std::memory_order_relaxed); }
+
+    /// Hash of the current frame (see display::HashWords), computed on demand:
+    /// the regression oracle's unit of comparison.
+    uint64_t FrameBufferHash() const {
+        uint64_t hash = chip8::display::HashWords(planes[0].Words().data(), planes[0].Words().size());
+        if constexpr (PLANES > 1) {
+            // Fold the second plane in; single-plane hashes (and their golden
+            // files) are untouched.
+            hash ^= chip8::display::HashWords(planes[1].Words().data(), planes[1].Words().size()) *
+                    0x9e3779b185ebca87ull;
+        }
+        return hash;
+    }
+
+    /// Streams one frame hash per 60Hz tick to `path` (see --hash-stream):
+    /// the golden files the regression runner records and diffs.
+    bool StartHashStream(const char* path) {
+        hashStream = std::fopen(path, "w");
+        return hashStream != nullptr;
+    }
+
+    /// Prints the register file, mainly so headless CI runs have something to diff.
+    void DumpCpuState() const {
+        std::fprintf(stdout, "[info] :: PC=0x%03x I=0x%03x SP=%u DT=%u ST=%u\n", cpu.PC, cpu.I,
+                     static_cast<unsigned>(cpu.SP), static_cast<unsigned>(cpu.delayTimer),
+                     static_cast<unsigned>(cpu.soundTimer));
+        for (std::size_t i = 0; i < chip8::system::CoreState::NUMBER_OF_V_REGISTERS; i++) {
+            std::fprintf(stdout, "[info] :: V%zX=0x%02x\n", i, static_cast<unsigned>(cpu.V[i]));
+        }
+    }
+
+    void Run() {
+
+        if (replayer.has_value()) {
+            RunReplay();
+            if (tracer.has_value()) {
+                tracer->Close();
+            }
+#ifdef CHIP8_PROFILE
+            DumpProfile();
+#endif
+            return;
+        }
+
+        if (config.headless) {
+            RunHeadless();
+            if (recorder.has_value()) {
+                recorder->Close();
+            }
+            if (tracer.has_value()) {
+                tracer->Close();
+            }
+#ifdef CHIP8_PROFILE
+            DumpProfile();
+#endif
+            return;
+        }
+
+        // SDL video init waits until here, after ROM loading: cold-starting
+        // many instances (batch, launchers) never pays for a window they
+        // would not use, and windowed startup overlaps nothing it needs.
+        screen.emplace(config);
+        beeper.emplace();
+        rewindBuffer.resize(REWIND_CAPACITY);
+
+        std::fprintf(stdout, "[info] :: cycles per frame: %u\n", config.cpuSpeed / 60);
+
+        // Emulation runs on its own thread so a slow frame never steals time
+        // from the instruction budget; this thread only polls events and paints
+        // published snapshots at the display rate.
+        running.store(true, std::memory_order_relaxed);
+        std::thread emulationThread{[this]() { EmulationLoop(); }};
+
+        while (running.load(std::memory_order_relaxed)) {
+            // Block on the event queue instead of polling: the timeout doubles
+            // as the frame pacing, and stretches out while the core is parked
+            // in FX0A so an idle instance barely wakes at all.
+            const int timeoutMs = idleWaiting.load(std::memory_order_relaxed)
+                                      ? IDLE_EVENT_TIMEOUT_MS
+                                      : static_cast<int>(chip8::display::MS_REFRESH_RATE);
+            screen->WaitEvent(timeoutMs, [this](const SDL_Event& event) { HandleEvent(event); });
+            // The empty critical section orders the notify after the waiter's
+            // predicate check: without it a notify landing between the check
+            // and the wait_for is lost, and a just-pushed key sits unseen
+            // until the timeout expires.
+            { std::lock_guard<std::mutex> lock{wakeMutex}; }
+            wakeCv.notify_one();
+
+            const int ready = snapshotReady.load(std::memory_order_acquire);
+            if (ready != -1) {
+                const uint64_t presentStart = SDL_GetPerformanceCounter();
+                if (hudEnabled.load(std::memory_order_relaxed)) {
+                    // Formatting happens here on the render thread, and only
+                    // while the HUD is up: the counters it reads are the
+                    // relaxed atomics the emulation thread already maintains.
+                    char ipsLine[48];
+                    char timeLine[48];
+                    char frameLine[48];
+                    std::snprintf(ipsLine, sizeof(ipsLine), "IPS %.0f / %u", MeasuredIps(),
+                                  config.cpuSpeed);
+                    std::snprintf(timeLine, sizeof(timeLine), "EMU %.1f UPD %.1f IDLE %.1f",
+                                  measuredEmulateMs.load(std::memory_order_relaxed),
+                                  measuredPresentMs.load(std::memory_order_relaxed),
+                                  measuredIdleMs.load(std::memory_order_relaxed));
+                    std::snprintf(frameLine, sizeof(frameLine), "DROP %llu DXYN %u",
+                                  static_cast<unsigned long long>(
+                                      droppedFrames.load(std::memory_order_relaxed)),
+                                  measuredDraws.load(std::memory_order_relaxed));
+                    const char* hudLines[] = {ipsLine, timeLine, frameLine};
+                    screen->Present(snapshots[ready], hudLines, 3);
+                } else {
+                    screen->Present(snapshots[ready]);
+                }
+                measuredPresentMs.store(
+                    static_cast<double>(SDL_GetPerformanceCounter() - presentStart) * 1000.0 /
+                        static_cast<double>(SDL_GetPerformanceFrequency()),
+                    std::memory_order_relaxed);
+                snapshotReady.store(-1, std::memory_order_release);
+            }
+        }
+
+        // Release the emulation thread if it is parked in an FX0A wait.
+        { std::lock_guard<std::mutex> lock{wakeMutex}; }
+        wakeCv.notify_one();
+        emulationThread.join();
+
+        if (recorder.has_value()) {
+            recorder->Close();
+        }
+        if (tracer.has_value()) {
+            tracer->Close();
+        }
+
+        std::fprintf(stdout, "[info] :: effective rate: %.2f Hz timers, %.0f instr/s\n", MeasuredHz(), MeasuredIps());
+#ifdef CHIP8_PROFILE
+        DumpProfile();
+#endif
+    }
+};
+
+/// The classic 64x32 machine with original COSMAC quirks: what every
+/// existing caller means by "Emulator".
+using Emulator = EmulatorCore<display::DISPLAY_WIDTH, display::DISPLAY_HEIGHT, quirks::Chip8>;
+/// 64x32 cores for ROMs written against the other dialects (see --quirks).
+using SchipQuirksEmulator = EmulatorCore<display::DISPLAY_WIDTH, display::DISPLAY_HEIGHT, quirks::Schip>;
+using XoChipEmulator = EmulatorCore<display::DISPLAY_WIDTH, display::DISPLAY_HEIGHT, quirks::XoChip>;
+/// The SUPER-CHIP hi-res machine, selected at ROM load (see --schip).
+using SchipEmulator = EmulatorCore<128, 64, quirks::Schip>;
+
+}  // namespace chip8
@@ -0,0 +1,209 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+
+namespace chip8 {
+
+namespace display {
+/// The base CHIP-8 resolution; SUPER-CHIP cores instantiate the templates
+/// below at 128x64 instead.
+constexpr std::uint32_t DISPLAY_WIDTH = 64;
+constexpr std::uint32_t DISPLAY_HEIGHT = 32;
+constexpr double MS_REFRESH_RATE = 16.67f;
+
+/// xxhash-style 64-bit hash over packed pixel rows, eating eight bytes per
+/// multiply-rotate step: for a 64x32 framebuffer that is 32 steps, cheap
+/// enough for a regression runner to take every frame. Deterministic across
+/// platforms, which is all the oracle needs.
+inline uint64_t HashWords(const uint64_t* words, const std::size_t count) {
+    constexpr uint64_t PRIME64_1 = 0x9e3779b185ebca87ull;
+    constexpr uint64_t PRIME64_2 = 0xc2b2ae3d27d4eb4full;
+    constexpr uint64_t PRIME64_3 = 0x165667b19e3779f9ull;
+    constexpr uint64_t PRIME64_4 = 0x85ebca77c2b2ae63ull;
+    constexpr uint64_t PRIME64_5 = 0x27d4eb2f165667c5ull;
+    const auto rotl = [](const uint64_t value, const int bits) {
+        return (value << bits) | (value >> (64 - bits));
+    };
+
+    uint64_t hash = PRIME64_5 + count * sizeof(uint64_t);
+    for (std::size_t i = 0; i < count; i++) {
+        hash ^= rotl(words[i] * PRIME64_2, 31) * PRIME64_1;
+        hash = rotl(hash, 27) * PRIME64_1 + PRIME64_4;
+    }
+    hash ^= hash >> 33;
+    hash *= PRIME64_2;
+    hash ^= hash >> 29;
+    hash *= PRIME64_3;
+    hash ^= hash >> 32;
+    return hash;
+}
+
+/// The emulator-core side of the display: a bit-packed pixel grid with dirty
+/// tracking, with no dependency on SDL or any other presentation layer.
+/// Width and height are template parameters so the 64x32 core keeps
+/// compile-time-constant indexing and SUPER-CHIP gets its own 128x64
+/// instantiation with the same code.
+template <uint32_t Width, uint32_t Height>
+class FrameBuffer {
+    static_assert(Width % 64 == 0, "rows must pack into whole 64-bit words");
+
+   public:
+    static constexpr std::size_t ROW_WORDS = Width / 64;
+    static constexpr std::size_t WORD_COUNT = ROW_WORDS * Height;
+
+    /// The packed pixel array, row-major: bit 63 of a row's first word is the
+    /// leftmost column.
+    using WordArray = std::array<uint64_t, WORD_COUNT>;
+
+   private:
+    WordArray data{};
+    /// Same layout as `data`: which pixels changed since the last present.
+    WordArray dirty{};
+
+    static constexpr std::size_t WordIndex(const std::size_t y, const std::size_t word) {
+        return y * ROW_WORDS + word;
+    }
+
+    /// XORs a mask into one word and reports whether a lit pixel was erased.
+    bool XorWord(const std::size_t y, const std::size_t word, const uint64_t mask) {
+        const std::size_t index = WordIndex(y, word);
+        const bool collision = (data[index] & mask) != 0;
+        data[index] ^= mask;
+        dirty[index] |= mask;
+        return collision;
+    }
+
+   public:
+    FrameBuffer() {
+        // Everything is dirty until the first present has painted the window.
+        dirty.fill(~static_cast<uint64_t>(0));
+    }
+
+    bool ReadPixel(const std::size_t x, const std::size_t y) const {
+        assert(x < Width);
+        assert(y < Height);
+        return (data[WordIndex(y, x / 64)] >> (63 - (x % 64))) & 1;
+    }
+
+    void DrawAll(const bool value) {
+        data.fill(value ? ~static_cast<uint64_t>(0) : 0);
+        dirty.fill(~static_cast<uint64_t>(0));
+    }
+
+    void Draw(const std::size_t x, const std::size_t y, const bool value) {
+        assert(x < Width);
+        assert(y < Height);
+        const std::size_t index = WordIndex(y, x / 64);
+        const uint64_t bit = static_cast<uint64_t>(1) << (63 - (x % 64));
+        if (static_cast<bool>(data[index] & bit) != value) {
+            dirty[index] |= bit;
+        }
+        data[index] = value ? (data[index] | bit) : (data[index] & ~bit);
+    }
+
+    /// XORs an 8-pixel sprite row in at column x (already wrapped by the
+    /// caller), clipping at the right edge, and reports whether any lit pixel
+    /// was erased. At most two word XORs, even when the sprite straddles a
+    /// word boundary on wide displays.
+    bool XorSpriteRow(const std::size_t y, const std::size_t x, const uint8_t bits) {
+        assert(x < Width);
+        assert(y < Height);
+        const std::size_t word = x / 64;
+        const std::size_t offset = x % 64;
+        if (offset <= 56) {
+            return XorWord(y, word, static_cast<uint64_t>(bits) << (56 - offset));
+        }
+        bool collision = XorWord(y, word, static_cast<uint64_t>(bits) >> (offset - 56));
+        if (word + 1 < ROW_WORDS) {
+            collision |= XorWord(y, word + 1, static_cast<uint64_t>(bits) << (64 - (offset - 56)));
+        }
+        return collision;
+    }
+
+    /// XORs a 16-pixel sprite row in at column x, the wide twin of
+    /// XorSpriteRow: SCHIP DXY0 sprites and lo-res pixel doubling both need
+    /// 16-bit rows. Same clipping, still at most two word XORs.
+    bool XorSpriteRow16(const std::size_t y, const std::size_t x, const uint16_t bits) {
+        assert(x < Width);
+        assert(y < Height);
+        const std::size_t word = x / 64;
+        const std::size_t offset = x % 64;
+        if (offset <= 48) {
+            return XorWord(y, word, static_cast<uint64_t>(bits) << (48 - offset));
+        }
+        bool collision = XorWord(y, word, static_cast<uint64_t>(bits) >> (offset - 48));
+        if (word + 1 < ROW_WORDS) {
+            collision |= XorWord(y, word + 1, static_cast<uint64_t>(bits) << (64 - (offset - 48)));
+        }
+        return collision;
+    }
+
+    /// SCHIP 00CN: scrolls the whole display down by `lines`, blanking the top.
+    /// Row-wise word moves, no per-pixel work.
+    void ScrollDown(const std::size_t lines) {
+        if (lines == 0) {
+            return;
+        }
+        for (std::size_t y = Height; y-- > 0;) {
+            for (std::size_t word = 0; word < ROW_WORDS; word++) {
+                data[WordIndex(y, word)] = (y >= lines) ? data[WordIndex(y - lines, word)] : 0;
+            }
+        }
+        dirty.fill(~static_cast<uint64_t>(0));
+    }
+
+    /// SCHIP 00FC: scrolls left by four pixels; each row is a word-wide shift
+    /// with the carry pulled in from the next word.
+    void ScrollLeft() {
+        for (std::size_t y = 0; y < Height; y++) {
+            for (std::size_t word = 0; word < ROW_WORDS; word++) {
+                const uint64_t carry =
+                    (word + 1 < ROW_WORDS) ? (data[WordIndex(y, word + 1)] >> 60) : 0;
+                data[WordIndex(y, word)] = (data[WordIndex(y, word)] << 4) | carry;
+            }
+        }
+        dirty.fill(~static_cast<uint64_t>(0));
+    }
+
+    /// SCHIP 00FB: scrolls right by four pixels, the mirror of ScrollLeft.
+    void ScrollRight() {
+        for (std::size_t y = 0; y < Height; y++) {
+            for (std::size_t word = ROW_WORDS; word-- > 0;) {
+                const uint64_t carry = (word > 0) ? (data[WordIndex(y, word - 1)] << 60) : 0;
+                data[WordIndex(y, word)] = (data[WordIndex(y, word)] >> 4) | carry;
+            }
+        }
+        dirty.fill(~static_cast<uint64_t>(0));
+    }
+
+    /// Raw view used by savestates and presents: a plain array of words.
+    const WordArray& Words() const { return data; }
+
+    /// Restores a savestate snapshot; everything becomes dirty so the next
+    /// present repaints the whole window.
+    void Restore(const WordArray& words) {
+        data = words;
+        dirty.fill(~static_cast<uint64_t>(0));
+    }
+
+    /// Tells whether any pixel changed since the last present.
+    bool IsDirty() const {
+        for (const auto word : dirty) {
+            if (word != 0) {
+                return true;
+            }
+        }
+        return false;
+    }
+
+    void ClearDirty() { dirty.fill(0); }
+};
+
+}  // namespace display
+
+}  // namespace chip8
@@ -0,0 +1,53 @@
+#pragma once
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+namespace chip8 {
+
+namespace graphics {
+namespace fonts {
+using Font = std::array<uint8_t, 80>;
+constexpr std::size_t FONT_ADDRESS_OFFSET = 0x50;
+constexpr Font DEFAULT = {
+    0xF0, 0x90, 0x90, 0x90, 0xF0,  // 0
+    0x20, 0x60, 0x20, 0x20, 0x70,  // 1
+    0xF0, 0x10, 0xF0, 0x80, 0xF0,  // 2
+    0xF0, 0x10, 0xF0, 0x10, 0xF0,  // 3
+    0x90, 0x90, 0xF0, 0x10, 0x10,  // 4
+    0xF0, 0x80, 0xF0, 0x10, 0xF0,  // 5
+    0xF0, 0x80, 0xF0, 0x90, 0xF0,  // 6
+    0xF0, 0x10, 0x20, 0x40, 0x40,  // 7
+    0xF0, 0x90, 0xF0, 0x90, 0xF0,  // 8
+    0xF0, 0x90, 0xF0, 0x10, 0xF0,  // 9
+    0xF0, 0x90, 0xF0, 0x90, 0x90,  // A
+    0xE0, 0x90, 0xE0, 0x90, 0xE0,  // B
+    0xF0, 0x80, 0x80, 0x80, 0xF0,  // C
+    0xE0, 0x90, 0x90, 0x90, 0xE0,  // D
+    0xF0, 0x80, 0xF0, 0x80, 0xF0,  // E
+    0xF0, 0x80, 0xF0, 0x80, 0x80   // F
+};
+}  // namespace fonts
+
+namespace colors {
+
+struct Color {
+    const uint8_t r;
+    const uint8_t g;
+    const uint8_t b;
+    const uint8_t a;
+
+    constexpr Color(const uint8_t r, const uint8_t g, const uint8_t b, const uint8_t a) : r{r}, g{g}, b{b}, a{a} {}
+};
+
+constexpr Color BLACK = {0x00, 0x00, 0x00, 0xff};
+constexpr Color WHITE = {0xff, 0xff, 0xff, 0xff};
+constexpr Color RED = {0xff, 0x00, 0x00, 0xff};
+constexpr Color GREEN = {0x00, 0xff, 0x00, 0xff};
+constexpr Color BLUE = {0x00, 0x00, 0xff, 0xff};
+}  // namespace colors
+
+}  // namespace graphics
+
+}  // namespace chip8
@@ -0,0 +1,271 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <fstream>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "config.hpp"
+#include "emulator.hpp"
+
+namespace chip8 {
+
+namespace grid {
+
+/// Pixel scale of each 64x32 cell. Smaller than the single-instance default:
+/// a 5x4 wall at this scale is 2560x1024, which still fits one display.
+constexpr uint32_t CELL_SCALE = 8;
+
+/// One hosted core: its own Emulator, Config and a small streaming texture.
+/// Per added instance this is the few KiB of core state plus a 64x32 texture,
+/// instead of a whole process with its own window and GL context.
+struct Instance {
+    std::unique_ptr<chip8::Emulator> emulator;
+    SDL_Texture* texture{nullptr};
+    std::string rom;
+    bool alive{false};
+};
+
+/// Hosts up to cols*rows Emulator cores in one process behind a single
+/// window and renderer. Each 60Hz tick the cores are stepped by a pool of
+/// worker threads claiming work off a shared counter (the same dynamic
+/// balancing the batch runner uses), then every dirty framebuffer is
+/// uploaded to its cell texture and the grid is composited in one pass.
+/// Hosted cores receive no input; FX0A waits idle in place.
+inline int Run(const char* layout, const char* manifestPath, const Config& baseConfig) {
+    unsigned cols = 0;
+    unsigned rows = 0;
+    if (std::sscanf(layout, "%ux%u", &cols, &rows) != 2 || cols == 0 || rows == 0) {
+        std::fprintf(stderr, "[error] :: bad grid layout '%s', expected e.g. 5x4\n", layout);
+        return EXIT_FAILURE;
+    }
+
+    std::vector<std::string> roms;
+    {
+        std::ifstream manifest{manifestPath};
+        if (!manifest) {
+            std::fprintf(stderr, "[error] :: could not open manifest '%s'\n", manifestPath);
+            return EXIT_FAILURE;
+        }
+        std::string line;
+        while (std::getline(manifest, line)) {
+            if (line.empty() || line[0] == '#') {
+                continue;
+            }
+            roms.push_back(line);
+        }
+    }
+    if (roms.empty()) {
+        std::fprintf(stderr, "[error] :: manifest '%s' lists no ROMs\n", manifestPath);
+        return EXIT_FAILURE;
+    }
+
+    const std::size_t cells = static_cast<std::size_t>(cols) * rows;
+    const std::size_t count = (roms.size() < cells) ? roms.size() : cells;
+
+    if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO) != 0) {
+        std::fprintf(stderr, "[error] :: %s\n", SDL_GetError());
+        return EXIT_FAILURE;
+    }
+    SDL_Window* window = SDL_CreateWindow("Chip8++ wall", SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                          cols * chip8::display::DISPLAY_WIDTH * CELL_SCALE,
+                                          rows * chip8::display::DISPLAY_HEIGHT * CELL_SCALE, 0);
+    SDL_Renderer* renderer =
+        (window != nullptr) ? SDL_CreateRenderer(window, -1, SDL_RENDERER_ACCELERATED) : nullptr;
+    if (renderer == nullptr) {
+        std::fprintf(stderr, "[error] :: %s\n", SDL_GetError());
+        SDL_Quit();
+        return EXIT_FAILURE;
+    }
+
+    // Every instance gets its own Config copy, so per-cell colors and cpuSpeed
+    // can diverge without any shared state between cores.
+    std::vector<Instance> instances(count);
+    for (std::size_t i = 0; i < count; i++) {
+        Instance& instance = instances[i];
+        instance.rom = roms[i];
+        try {
+            Config config = baseConfig;
+            instance.emulator = std::make_unique<chip8::Emulator>(config);
+            instance.emulator->LoadFont(std::move(chip8::graphics::fonts::DEFAULT));
+            if (!instance.emulator->LoadRomFromFile(roms[i].c_str())) {
+                std::fprintf(stderr, "[error] :: could not read rom '%s'\n", roms[i].c_str());
+                continue;
+            }
+            instance.texture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888,
+                                                 SDL_TEXTUREACCESS_STREAMING, chip8::display::DISPLAY_WIDTH,
+                                                 chip8::display::DISPLAY_HEIGHT);
+            if (instance.texture == nullptr) {
+                std::fprintf(stderr, "[error] :: %s\n", SDL_GetError());
+                continue;
+            }
+            instance.alive = true;
+        } catch (const std::exception& error) {
+            std::fprintf(stderr, "[error] :: %s: %s\n", roms[i].c_str(), error.what());
+        }
+    }
+
+    std::size_t jobs = std::thread::hardware_concurrency();
+    if (jobs == 0) {
+        jobs = 1;
+    }
+    if (jobs > count) {
+        jobs = count;
+    }
+
+    // Fork-join barrier, once per 60Hz tick: the render thread bumps the
+    // generation, workers claim cores off the shared counter until it runs
+    // dry, and the last one to finish signals completion.
+    std::mutex poolMutex;
+    std::condition_variable tickCv;
+    std::condition_variable doneCv;
+    std::atomic<std::size_t> nextCore{0};
+    uint64_t tickGeneration = 0;
+    std::size_t workersDone = 0;
+    bool running = true;
+
+    auto worker = [&]() {
+        uint64_t seenGeneration = 0;
+        while (true) {
+            {
+                std::unique_lock<std::mutex> lock{poolMutex};
+                tickCv.wait(lock, [&]() { return tickGeneration != seenGeneration || !running; });
+                if (!running) {
+                    return;
+                }
+                seenGeneration = tickGeneration;
+            }
+            while (true) {
+                const std::size_t index = nextCore.fetch_add(1);
+                if (index >= count) {
+                    break;
+                }
+                if (instances[index].alive) {
+                    instances[index].emulator->StepTick();
+                }
+            }
+            {
+                std::lock_guard<std::mutex> lock{poolMutex};
+                workersDone++;
+                if (workersDone == jobs) {
+                    doneCv.notify_one();
+                }
+            }
+        }
+    };
+
+    std::vector<std::thread> pool;
+    pool.reserve(jobs);
+    for (std::size_t i = 0; i < jobs; i++) {
+        pool.emplace_back(worker);
+    }
+
+    std::fprintf(stdout, "[info] :: wall mode: %zu cores on a %ux%u grid, %zu workers\n", count, cols,
+                 rows, jobs);
+
+    std::array<uint32_t, chip8::display::DISPLAY_WIDTH * chip8::display::DISPLAY_HEIGHT> pixels{};
+    const auto packColor = [](const chip8::graphics::colors::Color color) {
+        return (static_cast<uint32_t>(color.r) << 24) | (static_cast<uint32_t>(color.g) << 16) |
+               (static_cast<uint32_t>(color.b) << 8) | static_cast<uint32_t>(color.a);
+    };
+
+    const double frequency = static_cast<double>(SDL_GetPerformanceFrequency());
+    bool quit = false;
+    while (!quit) {
+        const uint64_t frameStart = SDL_GetPerformanceCounter();
+
+        // Step every core one tick on the pool.
+        nextCore.store(0, std::memory_order_relaxed);
+        {
+            std::lock_guard<std::mutex> lock{poolMutex};
+            workersDone = 0;
+            tickGeneration++;
+        }
+        tickCv.notify_all();
+        {
+            std::unique_lock<std::mutex> lock{poolMutex};
+            doneCv.wait(lock, [&]() { return workersDone == jobs; });
+        }
+
+        SDL_Event event{};
+        while (SDL_PollEvent(&event)) {
+            if (event.type == SDL_QUIT ||
+                (event.type == SDL_KEYDOWN && event.key.keysym.sym == SDLK_ESCAPE)) {
+                quit = true;
+            }
+        }
+
+        // Upload only the cells that changed, then composite the whole grid.
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0xff);
+        SDL_RenderClear(renderer);
+        for (std::size_t i = 0; i < count; i++) {
+            Instance& instance = instances[i];
+            if (!instance.alive) {
+                continue;
+            }
+            if (instance.emulator->FrameDirty()) {
+                const uint32_t fg = packColor(baseConfig.fgColor);
+                const uint32_t bg = packColor(baseConfig.bgColor);
+                const auto& words = instance.emulator->FrameWords();
+                for (std::size_t y = 0; y < chip8::display::DISPLAY_HEIGHT; y++) {
+                    for (std::size_t x = 0; x < chip8::display::DISPLAY_WIDTH; x++) {
+                        const uint64_t word = words[y];
+                        pixels[chip8::display::DISPLAY_WIDTH * y + x] =
+                            ((word >> (63 - x)) & 1) ? fg : bg;
+                    }
+                }
+                SDL_UpdateTexture(instance.texture, nullptr, pixels.data(),
+                                  chip8::display::DISPLAY_WIDTH * sizeof(uint32_t));
+                instance.emulator->ClearFrameDirty();
+            }
+            SDL_Rect cell{};
+            cell.x = static_cast<int>((i % cols) * chip8::display::DISPLAY_WIDTH * CELL_SCALE);
+            cell.y = static_cast<int>((i / cols) * chip8::display::DISPLAY_HEIGHT * CELL_SCALE);
+            cell.w = chip8::display::DISPLAY_WIDTH * CELL_SCALE;
+            cell.h = chip8::display::DISPLAY_HEIGHT * CELL_SCALE;
+            SDL_RenderCopy(renderer, instance.texture, nullptr, &cell);
+        }
+        SDL_RenderPresent(renderer);
+
+        // Coarse 60Hz pacing; a wall does not need the single-instance
+        // spin-wait precision.
+        const double elapsedMs =
+            static_cast<double>(SDL_GetPerformanceCounter() - frameStart) / frequency * 1000.0;
+        if (elapsedMs < chip8::display::MS_REFRESH_RATE) {
+            SDL_Delay(static_cast<uint32_t>(chip8::display::MS_REFRESH_RATE - elapsedMs));
+        }
+    }
+
+    {
+        std::lock_guard<std::mutex> lock{poolMutex};
+        running = false;
+    }
+    tickCv.notify_all();
+    for (auto& thread : pool) {
+        thread.join();
+    }
+
+    for (auto& instance : instances) {
+        if (instance.texture != nullptr) {
+            SDL_DestroyTexture(instance.texture);
+        }
+    }
+    SDL_DestroyRenderer(renderer);
+    SDL_DestroyWindow(window);
+    SDL_Quit();
+    return EXIT_SUCCESS;
+}
+
+}  // namespace grid
+
+}  // namespace chip8
@@ -0,0 +1,67 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+
+#include "config.hpp"
+
+namespace chip8 {
+
+namespace input {
+
+/// Table value for scancodes that do not map to the CHIP-8 keypad.
+constexpr uint8_t NO_KEY = 0xff;
+
+/// One slot per SDL scancode, so translating an event is a single array load.
+using ScancodeTable = std::array<uint8_t, SDL_NUM_SCANCODES>;
+
+/// The standard 4x4 CHIP-8 layout on a modern keyboard:
+///
+///     1 2 3 4        1 2 3 C
+///     Q W E R   ->   4 5 6 D
+///     A S D F        7 8 9 E
+///     Z X C V        A 0 B F
+constexpr ScancodeTable BuildDefaultTable() {
+    ScancodeTable table{};
+    for (auto& entry : table) {
+        entry = NO_KEY;
+    }
+    table[SDL_SCANCODE_1] = 0x1;
+    table[SDL_SCANCODE_2] = 0x2;
+    table[SDL_SCANCODE_3] = 0x3;
+    table[SDL_SCANCODE_4] = 0xc;
+    table[SDL_SCANCODE_Q] = 0x4;
+    table[SDL_SCANCODE_W] = 0x5;
+    table[SDL_SCANCODE_E] = 0x6;
+    table[SDL_SCANCODE_R] = 0xd;
+    table[SDL_SCANCODE_A] = 0x7;
+    table[SDL_SCANCODE_S] = 0x8;
+    table[SDL_SCANCODE_D] = 0x9;
+    table[SDL_SCANCODE_F] = 0xe;
+    table[SDL_SCANCODE_Z] = 0xa;
+    table[SDL_SCANCODE_X] = 0x0;
+    table[SDL_SCANCODE_C] = 0xb;
+    table[SDL_SCANCODE_V] = 0xf;
+    return table;
+}
+
+/// The default layout plus the Config overrides: any nonzero entry in
+/// Config::keypadScancodes binds that scancode to the keypad key at its index,
+/// on top of (not instead of) the standard layout.
+inline ScancodeTable BuildTable(const Config& config) {
+    ScancodeTable table = BuildDefaultTable();
+    for (std::size_t key = 0; key < config.keypadScancodes.size(); key++) {
+        const int32_t scancode = config.keypadScancodes[key];
+        if (scancode > 0 && static_cast<std::size_t>(scancode) < table.size()) {
+            table[scancode] = static_cast<uint8_t>(key);
+        }
+    }
+    return table;
+}
+
+}  // namespace input
+
+}  // namespace chip8
@@ -0,0 +1,57 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+
+namespace chip8 {
+
+namespace random {
+
+/// xoshiro128++: a small-state generator that is a handful of shifts, adds
+/// and rotates per draw. Each Emulator owns one, so instances in the same
+/// process never contend on shared generator state the way std::rand does.
+class Xoshiro128 {
+
+    std::array<uint32_t, 4> state{};
+
+    static constexpr uint32_t Rotl(const uint32_t x, const int k) { return (x << k) | (x >> (32 - k)); }
+
+   public:
+    explicit Xoshiro128(const uint64_t seed = 1) { Reseed(seed); }
+
+    /// Expands the seed through a splitmix64 pass so even tiny seeds
+    /// (including consecutive integers) fill all 128 state bits.
+    void Reseed(const uint64_t seed) {
+        uint64_t z = seed;
+        for (auto& word : state) {
+            z += 0x9e3779b97f4a7c15ull;
+            uint64_t mixed = z;
+            mixed = (mixed ^ (mixed >> 30)) * 0xbf58476d1ce4e5b9ull;
+            mixed = (mixed ^ (mixed >> 27)) * 0x94d049bb133111ebull;
+            word = static_cast<uint32_t>(mixed ^ (mixed >> 31));
+        }
+        // The all-zero state is the one fixed point the generator never leaves.
+        if (state[0] == 0 && state[1] == 0 && state[2] == 0 && state[3] == 0) {
+            state[0] = 1;
+        }
+    }
+
+    uint32_t Next() {
+        const uint32_t result = Rotl(state[0] + state[3], 7) + state[0];
+        const uint32_t t = state[1] << 9;
+        state[2] ^= state[0];
+        state[3] ^= state[1];
+        state[1] ^= state[2];
+        state[0] ^= state[3];
+        state[2] ^= t;
+        state[3] = Rotl(state[3], 11);
+        return result;
+    }
+
+    /// What CXNN wants: a byte, via mask rather than modulo.
+    uint8_t NextByte() { return Next() & 0xff; }
+};
+
+}  // namespace random
+
+}  // namespace chip8
@@ -0,0 +1,155 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <vector>
+
+namespace chip8 {
+
+namespace replay {
+
+/// Everything that can make two runs of the same ROM diverge: keypad
+/// transitions, CXNN draws and 60Hz timer ticks. Each event is stamped with
+/// the instruction count at which it happened, so a replay can re-apply it
+/// at exactly the same point without any wall-clock involvement.
+enum class EventType : uint8_t {
+    KEY_DOWN = 0,
+    KEY_UP = 1,
+    RNG_DRAW = 2,
+    TIMER_TICK = 3,
+};
+
+struct Event {
+    uint64_t instruction{0};
+    EventType type{EventType::TIMER_TICK};
+    uint8_t value{0};
+};
+
+/// On-disk format: a 5-byte header ('C8RC' + version) followed by packed
+/// 10-byte records (little-endian instruction count, type, value).
+constexpr std::array<uint8_t, 4> MAGIC = {'C', '8', 'R', 'C'};
+constexpr uint8_t VERSION = 1;
+constexpr std::size_t RECORD_SIZE = 10;
+
+/// Append-only buffered event writer. Appending packs ten bytes into a
+/// fixed in-object buffer: no allocation ever, and a write syscall only
+/// once per 64KiB (several minutes of play), so recording costs the
+/// per-frame path nothing measurable.
+class Recorder {
+    static constexpr std::size_t BUFFER_SIZE = 64 * 1024;
+
+    std::FILE* file{nullptr};
+    std::array<uint8_t, BUFFER_SIZE> buffer{};
+    std::size_t used{0};
+
+    void Flush() {
+        if (file != nullptr && used > 0) {
+            std::fwrite(buffer.data(), 1, used, file);
+            used = 0;
+        }
+    }
+
+   public:
+    Recorder() = default;
+    Recorder(const Recorder&) = delete;
+    Recorder& operator=(const Recorder&) = delete;
+
+    ~Recorder() { Close(); }
+
+    bool Open(const char* path) {
+        file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fwrite(MAGIC.data(), 1, MAGIC.size(), file);
+        std::fwrite(&VERSION, 1, 1, file);
+        return true;
+    }
+
+    void Append(const uint64_t instruction, const EventType type, const uint8_t value) {
+        if (file == nullptr) {
+            return;
+        }
+        if (used + RECORD_SIZE > BUFFER_SIZE) {
+            Flush();
+        }
+        for (std::size_t i = 0; i < 8; i++) {
+            buffer[used++] = static_cast<uint8_t>(instruction >> (8 * i));
+        }
+        buffer[used++] = static_cast<uint8_t>(type);
+        buffer[used++] = value;
+    }
+
+    void Close() {
+        if (file != nullptr) {
+            Flush();
+            std::fclose(file);
+            file = nullptr;
+        }
+    }
+};
+
+/// Loads a whole recording up front and hands the events back in order.
+/// Peeking is a pointer compare, so the replay loop can check for due
+/// events once per instruction without noticing.
+class Replayer {
+    std::vector<Event> events{};
+    std::size_t cursor{0};
+
+   public:
+    bool Load(const char* path) {
+        std::FILE* file = std::fopen(path, "rb");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fseek(file, 0, SEEK_END);
+        const long size = std::ftell(file);
+        std::fseek(file, 0, SEEK_SET);
+
+        const long headerSize = static_cast<long>(MAGIC.size()) + 1;
+        if (size < headerSize || (size - headerSize) % static_cast<long>(RECORD_SIZE) != 0) {
+            std::fclose(file);
+            return false;
+        }
+
+        std::array<uint8_t, 5> header{};
+        if (std::fread(header.data(), 1, header.size(), file) != header.size() ||
+            !std::equal(MAGIC.begin(), MAGIC.end(), header.begin()) || header[4] != VERSION) {
+            std::fclose(file);
+            return false;
+        }
+
+        const std::size_t count = static_cast<std::size_t>(size - headerSize) / RECORD_SIZE;
+        std::vector<uint8_t> raw(count * RECORD_SIZE);
+        const bool ok = std::fread(raw.data(), 1, raw.size(), file) == raw.size();
+        std::fclose(file);
+        if (!ok) {
+            return false;
+        }
+
+        events.resize(count);
+        for (std::size_t i = 0; i < count; i++) {
+            const uint8_t* record = raw.data() + i * RECORD_SIZE;
+            uint64_t instruction = 0;
+            for (std::size_t b = 0; b < 8; b++) {
+                instruction |= static_cast<uint64_t>(record[b]) << (8 * b);
+            }
+            events[i] = {instruction, static_cast<EventType>(record[8]), record[9]};
+        }
+        return true;
+    }
+
+    /// The next unconsumed event, or nullptr once the stream is exhausted.
+    const Event* Peek() const { return cursor < events.size() ? &events[cursor] : nullptr; }
+
+    void Advance() { cursor++; }
+
+    bool Done() const { return cursor >= events.size(); }
+};
+
+}  // namespace replay
+
+}  // namespace chip8
@@ -0,0 +1,308 @@
+#pragma once
+
+#include <SDL2/SDL.h>
+
+#include <array>
+#include <cstddef>
+#include <cstdint>
+#include <stdexcept>
+
+#include "SDL2/SDL_error.h"
+#include "SDL2/SDL_events.h"
+#include "SDL2/SDL_render.h"
+#include "SDL2/SDL_timer.h"
+#include "SDL2/SDL_video.h"
+#include "config.hpp"
+#include "framebuffer.hpp"
+
+namespace chip8 {
+
+namespace display {
+
+/// The HUD's 5x7 bitmap font: just the glyphs the overlay lines use, five
+/// bits wide in the high bits of each row byte. Baked into a one-row atlas
+/// texture at startup (see Screen::BuildGlyphAtlas), so drawing a HUD line
+/// is one texture copy per character, no per-pixel work at render time.
+struct HudGlyph {
+    char ch;
+    std::array<uint8_t, 7> rows;
+};
+
+constexpr std::array<HudGlyph, 26> HUD_FONT{{
+    {' ', {0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00}},
+    {'.', {0x00, 0x00, 0x00, 0x00, 0x00, 0x60, 0x60}},
+    {'/', {0x08, 0x08, 0x10, 0x20, 0x40, 0x80, 0x80}},
+    {'0', {0x70, 0x88, 0x98, 0xa8, 0xc8, 0x88, 0x70}},
+    {'1', {0x20, 0x60, 0x20, 0x20, 0x20, 0x20, 0x70}},
+    {'2', {0x70, 0x88, 0x08, 0x30, 0x40, 0x80, 0xf8}},
+    {'3', {0x70, 0x88, 0x08, 0x30, 0x08, 0x88, 0x70}},
+    {'4', {0x10, 0x30, 0x50, 0x90, 0xf8, 0x10, 0x10}},
+    {'5', {0xf8, 0x80, 0xf0, 0x08, 0x08, 0x88, 0x70}},
+    {'6', {0x30, 0x40, 0x80, 0xf0, 0x88, 0x88, 0x70}},
+    {'7', {0xf8, 0x08, 0x10, 0x20, 0x40, 0x40, 0x40}},
+    {'8', {0x70, 0x88, 0x88, 0x70, 0x88, 0x88, 0x70}},
+    {'9', {0x70, 0x88, 0x88, 0x78, 0x08, 0x10, 0x60}},
+    {'D', {0xf0, 0x88, 0x88, 0x88, 0x88, 0x88, 0xf0}},
+    {'E', {0xf8, 0x80, 0x80, 0xf0, 0x80, 0x80, 0xf8}},
+    {'I', {0x70, 0x20, 0x20, 0x20, 0x20, 0x20, 0x70}},
+    {'L', {0x80, 0x80, 0x80, 0x80, 0x80, 0x80, 0xf8}},
+    {'M', {0x88, 0xd8, 0xa8, 0xa8, 0x88, 0x88, 0x88}},
+    {'N', {0x88, 0xc8, 0xa8, 0x98, 0x88, 0x88, 0x88}},
+    {'O', {0x70, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70}},
+    {'P', {0xf0, 0x88, 0x88, 0xf0, 0x80, 0x80, 0x80}},
+    {'R', {0xf0, 0x88, 0x88, 0xf0, 0xa0, 0x90, 0x88}},
+    {'S', {0x78, 0x80, 0x80, 0x70, 0x08, 0x08, 0xf0}},
+    {'U', {0x88, 0x88, 0x88, 0x88, 0x88, 0x88, 0x70}},
+    {'X', {0x88, 0x88, 0x50, 0x20, 0x50, 0x88, 0x88}},
+    {'Y', {0x88, 0x88, 0x50, 0x20, 0x20, 0x20, 0x20}},
+}};
+
+/// The SDL presentation layer: owns the window, renderer and textures, and
+/// knows how to paint a FrameBuffer. The emulator core never touches SDL.
+/// Templated on the display size and plane count so each core variant
+/// (CHIP-8, SUPER-CHIP, two-plane XO-CHIP) gets fully specialized staging
+/// and unpacking code.
+template <uint32_t Width, uint32_t Height, std::size_t Planes = 1>
+class Screen {
+
+    static constexpr std::size_t ROW_WORDS = Width / 64;
+
+    /// CPU-side staging copy of the frame texture.
+    std::array<uint32_t, Width * Height> pixels{};
+    SDL_Window* windowHandle{nullptr};
+    SDL_Renderer* renderer{nullptr};
+    /// Native-resolution streaming texture: the framebuffer is blitted here once per frame and the GPU scales it.
+    SDL_Texture* frameTexture{nullptr};
+    /// Pre-built scan line grid, composited over the frame texture in a single draw call.
+    SDL_Texture* scanlineTexture{nullptr};
+    /// Pre-baked HUD glyph atlas, one 6x8 cell per HUD_FONT entry.
+    SDL_Texture* glyphTexture{nullptr};
+
+    static constexpr int GLYPH_WIDTH = 6;   /// 5 pixel columns plus spacing.
+    static constexpr int GLYPH_HEIGHT = 8;  /// 7 pixel rows plus spacing.
+    static constexpr int HUD_SCALE = 2;
+
+    Config config;
+
+    static constexpr uint32_t PackColor(const chip8::graphics::colors::Color color) {
+        return (static_cast<uint32_t>(color.r) << 24) | (static_cast<uint32_t>(color.g) << 16) |
+               (static_cast<uint32_t>(color.b) << 8) | static_cast<uint32_t>(color.a);
+    }
+
+    void BuildScanlineTexture(const int pixelWidth, const int pixelHeight) {
+        // The grid only depends on the window size, so we render it once into an
+        // alpha-blended target texture instead of issuing 2048 draw calls per frame.
+        // Rebuilt on resize (see HandleResize) so the lines track the cell edges.
+        scanlineTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                            pixelWidth, pixelHeight);
+        if (scanlineTexture == nullptr) {
+            throw std::runtime_error{SDL_GetError()};
+        }
+        SDL_SetTextureBlendMode(scanlineTexture, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderTarget(renderer, scanlineTexture);
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+        SDL_RenderClear(renderer);
+        const auto [r, g, b, a] = config.scanline;
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        for (std::size_t x = 0; x < Width; x++) {
+            for (std::size_t y = 0; y < Height; y++) {
+                // Cell edges are computed by division, not a fixed stride, so
+                // they stay aligned with the stretched frame texture at any size.
+                SDL_Rect rect{};
+                rect.x = static_cast<int>(x * pixelWidth / Width);
+                rect.y = static_cast<int>(y * pixelHeight / Height);
+                rect.w = static_cast<int>((x + 1) * pixelWidth / Width) - rect.x;
+                rect.h = static_cast<int>((y + 1) * pixelHeight / Height) - rect.y;
+                SDL_RenderDrawRect(renderer, &rect);
+            }
+        }
+        SDL_SetRenderTarget(renderer, nullptr);
+    }
+
+    /// Renders every HUD glyph once into a one-row target texture, so HUD
+    /// text draws as atlas copies instead of per-pixel work every frame.
+    void BuildGlyphAtlas() {
+        glyphTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_TARGET,
+                                         GLYPH_WIDTH * static_cast<int>(HUD_FONT.size()), GLYPH_HEIGHT);
+        if (glyphTexture == nullptr) {
+            throw std::runtime_error{SDL_GetError()};
+        }
+        SDL_SetTextureBlendMode(glyphTexture, SDL_BLENDMODE_BLEND);
+        SDL_SetRenderTarget(renderer, glyphTexture);
+        SDL_SetRenderDrawColor(renderer, 0x00, 0x00, 0x00, 0x00);
+        SDL_RenderClear(renderer);
+        SDL_SetRenderDrawColor(renderer, 0xff, 0xff, 0xff, 0xff);
+        for (std::size_t glyph = 0; glyph < HUD_FONT.size(); glyph++) {
+            for (int row = 0; row < 7; row++) {
+                for (int col = 0; col < 5; col++) {
+                    if (HUD_FONT[glyph].rows[row] & (0x80 >> col)) {
+                        SDL_RenderDrawPoint(renderer, static_cast<int>(glyph) * GLYPH_WIDTH + col, row);
+                    }
+                }
+            }
+        }
+        SDL_SetRenderTarget(renderer, nullptr);
+    }
+
+    /// One atlas copy per character; unknown characters draw as blanks.
+    void DrawHudText(const int x, const int y, const char* text) {
+        for (int i = 0; text[i] != '\0'; i++) {
+            for (std::size_t glyph = 0; glyph < HUD_FONT.size(); glyph++) {
+                if (HUD_FONT[glyph].ch != text[i]) {
+                    continue;
+                }
+                const SDL_Rect src{static_cast<int>(glyph) * GLYPH_WIDTH, 0, GLYPH_WIDTH, GLYPH_HEIGHT};
+                const SDL_Rect dst{x + i * GLYPH_WIDTH * HUD_SCALE, y, GLYPH_WIDTH * HUD_SCALE,
+                                   GLYPH_HEIGHT * HUD_SCALE};
+                SDL_RenderCopy(renderer, glyphTexture, &src, &dst);
+                break;
+            }
+        }
+    }
+
+    /// Repaints from the current frame texture without fresh pixel data:
+    /// enough to refresh the window right after a resize.
+    void Redraw() {
+        CleanScreen();
+        SDL_RenderCopy(renderer, frameTexture, nullptr, nullptr);
+        if (config.useScanline) {
+            SDL_RenderCopy(renderer, scanlineTexture, nullptr, nullptr);
+        }
+        SDL_RenderPresent(renderer);
+    }
+
+   public:
+    Screen(Config c, const char* title = "Chip8++") : config{c} {
+        // Audio is not initialized here: whatever produces sound brings up
+        // its own subsystem on first use, so silent startups stay cheap.
+        if (SDL_Init(SDL_INIT_TIMER | SDL_INIT_VIDEO) != 0) {
+            throw std::runtime_error{SDL_GetError()};
+        }
+        windowHandle = SDL_CreateWindow(title, SDL_WINDOWPOS_CENTERED, SDL_WINDOWPOS_CENTERED,
+                                        Width * config.scaleFactor, Height * config.scaleFactor,
+                                        SDL_WINDOW_RESIZABLE);
+        if (windowHandle == nullptr) {
+            throw std::runtime_error{SDL_GetError()};
+        }
+        renderer = SDL_CreateRenderer(windowHandle, -1, SDL_RENDERER_ACCELERATED);
+        if (renderer == nullptr) {
+            throw std::runtime_error{SDL_GetError()};
+        }
+        frameTexture = SDL_CreateTexture(renderer, SDL_PIXELFORMAT_RGBA8888, SDL_TEXTUREACCESS_STREAMING,
+                                         Width, Height);
+        if (frameTexture == nullptr) {
+            throw std::runtime_error{SDL_GetError()};
+        }
+        if (config.useScanline) {
+            BuildScanlineTexture(Width * config.scaleFactor, Height * config.scaleFactor);
+        }
+        BuildGlyphAtlas();
+    }
+
+    Screen(const Screen&) = delete;
+    Screen& operator=(const Screen&) = delete;
+
+    ~Screen() noexcept {
+        if (glyphTexture != nullptr) {
+            SDL_DestroyTexture(glyphTexture);
+        }
+        if (scanlineTexture != nullptr) {
+            SDL_DestroyTexture(scanlineTexture);
+        }
+        if (frameTexture != nullptr) {
+            SDL_DestroyTexture(frameTexture);
+        }
+        if (renderer != nullptr) {
+            SDL_DestroyRenderer(renderer);
+        }
+        if (windowHandle != nullptr) {
+            SDL_DestroyWindow(windowHandle);
+        }
+        SDL_Quit();
+    }
+
+    void CleanScreen() {
+        auto [r, g, b, a] = config.bgColor;
+        SDL_SetRenderDrawColor(renderer, r, g, b, a);
+        SDL_RenderClear(renderer);
+    }
+
+    /// Reacts to the window taking a new size: the frame texture stays at
+    /// native resolution (the GPU stretches it), only the scanline grid is
+    /// geometry-dependent and needs a rebuild. Repaints immediately so the
+    /// window never shows a stale stretch until the next dirty frame.
+    void HandleResize(const int pixelWidth, const int pixelHeight) {
+        if (config.useScanline) {
+            SDL_DestroyTexture(scanlineTexture);
+            BuildScanlineTexture(pixelWidth, pixelHeight);
+        }
+        Redraw();
+    }
+
+    template <typename Callback>
+    void PollEvent(const Callback callback) {
+        SDL_Event e{};
+        while (SDL_PollEvent(&e)) {
+            callback(e);
+        }
+    }
+
+    /// Blocks for up to `timeoutMs` waiting for the first event, then drains
+    /// whatever else is queued. Returns without calling back on timeout, so
+    /// the caller's loop doubles as its frame pacing.
+    template <typename Callback>
+    void WaitEvent(const int timeoutMs, const Callback callback) {
+        SDL_Event e{};
+        if (SDL_WaitEventTimeout(&e, timeoutMs) == 1) {
+            callback(e);
+            while (SDL_PollEvent(&e)) {
+                callback(e);
+            }
+        }
+    }
+
+    /// Paints a framebuffer snapshot (packed words, row-major, one array per
+    /// plane). The caller only hands us a snapshot when something changed, so
+    /// a full texture refresh here is still cheap: Width x Height staging
+    /// writes plus one upload. Planes composite during the unpack: the words
+    /// merge bitwise, two shifts per pixel instead of one, and the pair of
+    /// bits indexes a four-entry palette — no separate blend pass.
+    void Present(const std::array<std::array<uint64_t, ROW_WORDS * Height>, Planes>& planes,
+                 const char* const* hudLines = nullptr, const std::size_t hudLineCount = 0) {
+
+        CleanScreen();
+
+        const std::array<uint32_t, 4> palette{
+            PackColor(config.bgColor),
+            PackColor(config.fgColor),
+            PackColor(config.plane2Color),
+            PackColor(config.planeBlendColor),
+        };
+
+        for (std::size_t y = 0; y < Height; y++) {
+            for (std::size_t x = 0; x < Width; x++) {
+                const std::size_t index = y * ROW_WORDS + x / 64;
+                const int shift = static_cast<int>(63 - (x % 64));
+                uint64_t colorBits = (planes[0][index] >> shift) & 1;
+                if constexpr (Planes > 1) {
+                    colorBits |= ((planes[1][index] >> shift) & 1) << 1;
+                }
+                pixels[Width * y + x] = palette[colorBits];
+            }
+        }
+        SDL_UpdateTexture(frameTexture, nullptr, pixels.data(), Width * sizeof(uint32_t));
+
+        SDL_RenderCopy(renderer, frameTexture, nullptr, nullptr);
+        if (config.useScanline) {
+            SDL_RenderCopy(renderer, scanlineTexture, nullptr, nullptr);
+        }
+        for (std::size_t line = 0; line < hudLineCount; line++) {
+            DrawHudText(4, 4 + static_cast<int>(line) * (GLYPH_HEIGHT * HUD_SCALE + 2), hudLines[line]);
+        }
+        SDL_RenderPresent(renderer);
+    }
+};
+
+}  // namespace display
+
+}  // namespace chip8
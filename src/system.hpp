@@ -0,0 +1,293 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <cassert>
+#include <csignal>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <iterator>
+#include <stdexcept>
+#include <type_traits>
+#include <vector>
+
+#include "common.hpp"
+
+namespace chip8 {
+
+namespace system {
+
+/// The whole register file in one packed POD, about 64 bytes: registers,
+/// stack, timers, the FX0A wait slot and the keypad bitmask all live in two
+/// cache lines, so a hot interpreter loop (and hundreds of batch or grid
+/// cores sharing L2) never chases state across separate objects. Savestates
+/// memcpy it as a unit.
+struct CoreState {
+    static constexpr std::size_t STARTING_PC = 0x200;
+    static constexpr std::size_t NUMBER_OF_V_REGISTERS = 0x10;
+    static constexpr std::size_t STACK_SIZE = 0x10;
+    static constexpr uint8_t NO_PENDING_KEY = 0xff;
+
+    /// Points at the current instruction in memory (12 bits used).
+    uint16_t PC{STARTING_PC};
+    /// The index register (12 bits used).
+    uint16_t I{0};
+    /// The stack holds 16 16-bit values (up to 16 nested subroutines).
+    std::array<uint16_t, STACK_SIZE> stack{};
+    /// Named V0, V1, V2, ..., VF (used as flag register).
+    std::array<uint8_t, NUMBER_OF_V_REGISTERS> V{};
+    /// Stack Pointer
+    uint8_t SP{0};
+    /// Decremented at rate of 60hz until it reaches 0.
+    uint8_t delayTimer{0};
+    /// Decremented at rate of 60hz until it reaches 0.
+    uint8_t soundTimer{0};
+    /// Pending FX0A destination register, or NO_PENDING_KEY.
+    uint8_t waitingKeyRegister{NO_PENDING_KEY};
+    /// The hexadecimal keypad as a bitmask: bit N is set while key N is held.
+    uint16_t keypad{0};
+    /// XO-CHIP drawing-plane bitmask (FN01); stays at 1 on single-plane dialects.
+    uint8_t planeMask{1};
+    /// SUPER-CHIP display mode (00FF/00FE): set while in 128x64 hi-res. Stays
+    /// 0 on cores whose display is 64x32, which boot and remain in lo-res.
+    uint8_t highRes{0};
+};
+
+static_assert(sizeof(CoreState) <= 96, "the register file must stay within two cache lines");
+static_assert(std::is_trivially_copyable_v<CoreState>, "core state must stay memcpy-able");
+
+/// Bus policies for Memory. Fast is the release bus: direct array access,
+/// zero added instructions on the hot loads. Checked is the debug bus:
+/// bounds checks, read/write watchpoints and an access-log ring.
+struct FastBus {};
+struct CheckedBus {};
+
+/// Debug-bus state, mixed in as an (empty for Fast) base so the release
+/// Memory object carries none of it. Mutable because reads must log too.
+struct CheckedBusState {
+    struct Watchpoint {
+        uint16_t address{0};
+        bool onRead{false};
+        bool onWrite{false};
+    };
+    struct Access {
+        uint16_t address{0};
+        uint8_t value{0};
+        bool write{false};
+    };
+
+    static constexpr std::size_t MAX_WATCHPOINTS = 8;
+    static constexpr std::size_t ACCESS_LOG_SIZE = 256;
+
+    mutable std::array<Watchpoint, MAX_WATCHPOINTS> watchpoints{};
+    mutable std::size_t watchpointCount{0};
+    mutable std::array<Access, ACCESS_LOG_SIZE> accessLog{};
+    mutable std::size_t accessLogNext{0};
+};
+
+struct FastBusState {};
+
+/// Backing-store size is a template parameter: the base CHIP-8 build keeps
+/// its 4KiB footprint (and cache behaviour) while XO-CHIP instantiates the
+/// same bus over 64KiB.
+template <typename Bus = FastBus, std::size_t Size = 1 << 12>
+class MemoryT : private std::conditional_t<std::is_same_v<Bus, CheckedBus>, CheckedBusState, FastBusState> {
+   public:
+    static constexpr std::size_t MEMORY_SIZE = Size;
+    /// How many bytes before a written address block starts can reach: twice
+    /// the longest block, in bytes. The emulator static_asserts against this.
+    static constexpr std::size_t BLOCK_INVALIDATION_WINDOW = 64;
+
+   private:
+    std::array<uint8_t, MEMORY_SIZE> data{};
+    /// Valid bits of the owner's decoded-instruction cache, cleared on every write so
+    /// self-modifying code (Fx55/Fx33 are the only sources) never runs a stale decode.
+    std::array<bool, MEMORY_SIZE>* decodedValid{nullptr};
+    /// Valid bits of the owner's basic-block cache, cleared over a window on
+    /// every write (see BLOCK_INVALIDATION_WINDOW).
+    std::array<bool, MEMORY_SIZE>* blockValid{nullptr};
+
+    void InvalidateDecoded(const std::size_t address) {
+        if (decodedValid != nullptr) {
+            // An instruction spans two bytes: a write at `address` also clobbers
+            // the instruction starting one byte earlier.
+            (*decodedValid)[address] = false;
+            if (address > 0) {
+                (*decodedValid)[address - 1] = false;
+            }
+        }
+        if (blockValid != nullptr) {
+            // A write can sit inside any block whose straight-line run reaches
+            // it, and blocks start at most the window size earlier. Writes are
+            // rare next to executes, so the window sweep is off the hot path.
+            const std::size_t first =
+                (address > BLOCK_INVALIDATION_WINDOW) ? address - BLOCK_INVALIDATION_WINDOW : 0;
+            for (std::size_t a = first; a <= address; a++) {
+                (*blockValid)[a] = false;
+            }
+        }
+    }
+
+    /// Checked bus only: bounds check, append to the access-log ring, and
+    /// report watchpoint hits. Never instantiated on the Fast bus.
+    void Note(const std::size_t address, const uint8_t value, const bool write) const {
+        assert(address < MEMORY_SIZE);
+        this->accessLog[this->accessLogNext] = {static_cast<uint16_t>(address), value, write};
+        this->accessLogNext = (this->accessLogNext + 1) % CheckedBusState::ACCESS_LOG_SIZE;
+        for (std::size_t i = 0; i < this->watchpointCount; i++) {
+            const auto& wp = this->watchpoints[i];
+            if (wp.address == address && (write ? wp.onWrite : wp.onRead)) {
+                std::fprintf(stderr, "[debug] :: watchpoint hit: %s 0x%03zx value=0x%02x\n",
+                             write ? "write" : "read", address, static_cast<unsigned>(value));
+                std::raise(SIGTRAP);
+            }
+        }
+    }
+
+   public:
+    /// Hooks the emulator's decoded-instruction valid bits into the write path.
+    void AttachDecodedCache(std::array<bool, MEMORY_SIZE>* validBits) { decodedValid = validBits; }
+
+    /// Hooks the emulator's basic-block valid bits into the write path.
+    void AttachBlockCache(std::array<bool, MEMORY_SIZE>* validBits) { blockValid = validBits; }
+
+    uint8_t Read8(const std::size_t address) const {
+        if constexpr (std::is_same_v<Bus, CheckedBus>) {
+            Note(address, data[address], false);
+        }
+        return data[address];
+    }
+
+    uint16_t Read16(const std::size_t address) const {
+        if constexpr (std::is_same_v<Bus, CheckedBus>) {
+            Note(address, data[address], false);
+            Note(address + 1, data[address + 1], false);
+        }
+        return PACK16(data[address], data[address + 1]);
+    }
+
+    void Write8(const std::size_t address, const uint8_t value) {
+        if constexpr (std::is_same_v<Bus, CheckedBus>) {
+            Note(address, value, true);
+        }
+        data[address] = value;
+        InvalidateDecoded(address);
+    }
+
+    void Write16(const std::size_t address, const uint16_t value) {
+        uint8_t msb = (value >> 8) & 0xff;
+        uint8_t lsb = (value >> 0) & 0xff;
+        if constexpr (std::is_same_v<Bus, CheckedBus>) {
+            Note(address, msb, true);
+            Note(address + 1, lsb, true);
+        }
+        data[address] = msb;
+        data[address + 1] = lsb;
+        InvalidateDecoded(address);
+        InvalidateDecoded(address + 1);
+    }
+
+    template <size_t N>
+    void WriteBytes(const std::array<uint8_t, N>&& input, const std::size_t offset) {
+        if (input.size() + offset >= MEMORY_SIZE) {
+            throw std::invalid_argument{"The data to write could not be stored."};
+        }
+        auto dest = data.begin();
+        std::advance(dest, offset);
+        std::copy_n(input.begin(), input.size(), dest);
+        for (std::size_t i = 0; i < input.size(); i++) {
+            InvalidateDecoded(offset + i);
+        }
+    }
+
+    void WriteBytes(const std::vector<uint8_t>&& input, const std::size_t offset = 0) {
+        if (input.size() + offset >= MEMORY_SIZE) {
+            throw std::invalid_argument{"The data to write could not be stored."};
+        }
+        auto dest = data.begin();
+        std::advance(dest, offset);
+        std::copy_n(input.begin(), input.size(), dest);
+        for (std::size_t i = 0; i < input.size(); i++) {
+            InvalidateDecoded(offset + i);
+        }
+    }
+
+    /// Hands out a writable window for bulk loads, so a ROM can be read off
+    /// disk straight into memory with no intermediate buffer. The decoded
+    /// cache is invalidated for the whole window up front. Bulk loads are
+    /// setup, not emulation, so the checked bus does not log them.
+    uint8_t* WritableWindow(const std::size_t offset, const std::size_t size) {
+        if (offset + size >= MEMORY_SIZE) {
+            throw std::invalid_argument{"The data to write could not be stored."};
+        }
+        for (std::size_t i = 0; i < size; i++) {
+            InvalidateDecoded(offset + i);
+        }
+        return data.data() + offset;
+    }
+
+    /// Checked bus only: arms a watchpoint. A no-op on the release bus.
+    void AddWatchpoint(const uint16_t address, const bool onRead, const bool onWrite) {
+        if constexpr (std::is_same_v<Bus, CheckedBus>) {
+            if (this->watchpointCount < CheckedBusState::MAX_WATCHPOINTS) {
+                this->watchpoints[this->watchpointCount++] = {address, onRead, onWrite};
+            }
+        } else {
+            (void)address;
+            (void)onRead;
+            (void)onWrite;
+        }
+    }
+
+    /// Checked bus only: prints the most recent accesses, oldest first.
+    void DumpAccessLog(std::size_t count = CheckedBusState::ACCESS_LOG_SIZE) const {
+        if constexpr (std::is_same_v<Bus, CheckedBus>) {
+            if (count > CheckedBusState::ACCESS_LOG_SIZE) {
+                count = CheckedBusState::ACCESS_LOG_SIZE;
+            }
+            for (std::size_t i = 0; i < count; i++) {
+                const std::size_t index =
+                    (this->accessLogNext + CheckedBusState::ACCESS_LOG_SIZE - count + i) %
+                    CheckedBusState::ACCESS_LOG_SIZE;
+                const auto& access = this->accessLog[index];
+                std::fprintf(stderr, "[debug] :: %s 0x%03x value=0x%02x\n", access.write ? "write" : "read ",
+                             access.address, static_cast<unsigned>(access.value));
+            }
+        } else {
+            (void)count;
+        }
+    }
+
+    /// Raw view used by savestates: snapshotting is a plain array copy.
+    const std::array<uint8_t, MEMORY_SIZE>& Raw() const { return data; }
+
+    /// Restores a savestate snapshot. Every byte may have changed, so the
+    /// whole decoded-instruction cache is dropped.
+    void Restore(const std::array<uint8_t, MEMORY_SIZE>& bytes) {
+        data = bytes;
+        if (decodedValid != nullptr) {
+            decodedValid->fill(false);
+        }
+        if (blockValid != nullptr) {
+            blockValid->fill(false);
+        }
+    }
+};
+
+/// The Makefile's debug/release split picks the bus: debug builds (-DDEBUG)
+/// get the checked bus, release keeps the direct-access one. The size stays
+/// a free parameter so each dialect picks its own address space.
+#ifdef DEBUG
+template <std::size_t Size = 1 << 12>
+using MemorySized = MemoryT<CheckedBus, Size>;
+#else
+template <std::size_t Size = 1 << 12>
+using MemorySized = MemoryT<FastBus, Size>;
+#endif
+
+using Memory = MemorySized<>;
+
+}  // namespace system
+
+}  // namespace chip8
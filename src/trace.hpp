@@ -0,0 +1,160 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+
+namespace chip8 {
+
+namespace trace {
+
+/// One executed instruction in eight bytes: where it ran, what it was, and
+/// the registers it most plausibly changed (Vx for x = the opcode's second
+/// nibble, the flag register, and I). Fixed size, so the ring and the on-disk
+/// stream are both plain arrays of these.
+struct Record {
+    uint16_t pc{0};
+    uint16_t opcode{0};
+    /// Vx after execution, x = second nibble of the opcode.
+    uint8_t vx{0};
+    /// VF after execution.
+    uint8_t vf{0};
+    /// I after execution.
+    uint16_t i{0};
+};
+
+static_assert(sizeof(Record) == 8, "trace records must stay fixed-size");
+
+/// On-disk format: a 5-byte header ('C8TR' + version) followed by raw records.
+constexpr std::array<uint8_t, 4> MAGIC = {'C', '8', 'T', 'R'};
+constexpr uint8_t VERSION = 1;
+
+/// Lock-free single-producer tracing: the emulation thread drops records into
+/// a preallocated ring (one enabled check plus one full check on the hot
+/// path, no formatting, no syscall), and a background thread streams filled
+/// stretches to disk in large contiguous fwrites. When the disk cannot keep
+/// up the newest records are dropped and counted rather than stalling the
+/// interpreter, so tracing can stay on during full-speed runs.
+class Tracer {
+    static constexpr std::size_t RING_SIZE = 1 << 16;  /// 64K records, 512KiB.
+    static_assert((RING_SIZE & (RING_SIZE - 1)) == 0, "ring indices wrap with a mask");
+
+    std::vector<Record> ring;
+    /// Producer bumps head, the flusher thread bumps tail.
+    std::atomic<std::size_t> head{0};
+    std::atomic<std::size_t> tail{0};
+    std::atomic<uint64_t> dropped{0};
+    std::atomic<bool> running{false};
+    std::FILE* file{nullptr};
+    std::thread flusher;
+
+    void FlushLoop() {
+        while (true) {
+            const std::size_t h = head.load(std::memory_order_acquire);
+            const std::size_t t = tail.load(std::memory_order_relaxed);
+            if (t == h) {
+                if (!running.load(std::memory_order_acquire)) {
+                    return;
+                }
+                std::this_thread::sleep_for(std::chrono::milliseconds(2));
+                continue;
+            }
+            // Flush the contiguous stretch up to the head or the ring end,
+            // whichever comes first; the wrap-around remainder goes next pass.
+            const std::size_t end = (h > t) ? h : RING_SIZE;
+            std::fwrite(&ring[t], sizeof(Record), end - t, file);
+            tail.store(end & (RING_SIZE - 1), std::memory_order_release);
+        }
+    }
+
+   public:
+    Tracer() = default;
+    Tracer(const Tracer&) = delete;
+    Tracer& operator=(const Tracer&) = delete;
+
+    ~Tracer() { Close(); }
+
+    bool Open(const char* path) {
+        file = std::fopen(path, "wb");
+        if (file == nullptr) {
+            return false;
+        }
+        std::fwrite(MAGIC.data(), 1, MAGIC.size(), file);
+        std::fwrite(&VERSION, 1, 1, file);
+        ring.resize(RING_SIZE);
+        running.store(true, std::memory_order_release);
+        flusher = std::thread([this]() { FlushLoop(); });
+        return true;
+    }
+
+    /// Hot path: one slot store and an index bump. A full ring drops the
+    /// record instead of blocking the emulation thread.
+    void Emit(const Record& record) {
+        const std::size_t h = head.load(std::memory_order_relaxed);
+        const std::size_t next = (h + 1) & (RING_SIZE - 1);
+        if (next == tail.load(std::memory_order_acquire)) {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+        ring[h] = record;
+        head.store(next, std::memory_order_release);
+    }
+
+    void Close() {
+        if (file == nullptr) {
+            return;
+        }
+        // The producer has stopped by now: let the flusher drain what is left.
+        running.store(false, std::memory_order_release);
+        flusher.join();
+        std::fclose(file);
+        file = nullptr;
+        const uint64_t droppedCount = dropped.load(std::memory_order_relaxed);
+        if (droppedCount > 0) {
+            std::fprintf(stderr, "[info] :: trace dropped %llu records (disk could not keep up)\n",
+                         static_cast<unsigned long long>(droppedCount));
+        }
+    }
+};
+
+/// Offline pretty-printer for a recorded trace (see --trace-dump): one text
+/// line per record, oldest first.
+inline int Dump(const char* path) {
+    std::FILE* file = std::fopen(path, "rb");
+    if (file == nullptr) {
+        std::fprintf(stderr, "[error] :: could not open trace '%s'\n", path);
+        return EXIT_FAILURE;
+    }
+    std::array<uint8_t, 5> header{};
+    if (std::fread(header.data(), 1, header.size(), file) != header.size() ||
+        !std::equal(MAGIC.begin(), MAGIC.end(), header.begin()) || header[4] != VERSION) {
+        std::fprintf(stderr, "[error] :: '%s' is not a version-%u trace\n", path,
+                     static_cast<unsigned>(VERSION));
+        std::fclose(file);
+        return EXIT_FAILURE;
+    }
+    std::array<Record, 4096> block{};
+    uint64_t index = 0;
+    std::size_t read = 0;
+    while ((read = std::fread(block.data(), sizeof(Record), block.size(), file)) > 0) {
+        for (std::size_t i = 0; i < read; i++) {
+            const Record& record = block[i];
+            std::fprintf(stdout, "[trace] :: #%-10llu pc=0x%03x op=0x%04x Vx=0x%02x VF=0x%02x I=0x%03x\n",
+                         static_cast<unsigned long long>(index++), record.pc, record.opcode,
+                         static_cast<unsigned>(record.vx), static_cast<unsigned>(record.vf), record.i);
+        }
+    }
+    std::fclose(file);
+    return EXIT_SUCCESS;
+}
+
+}  // namespace trace
+
+}  // namespace chip8